@@ -0,0 +1,719 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "distributed.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#ifdef PAGERANK_MPI
+#include <mpi.h>
+#endif
+
+#include "generate.hxx"
+#include "graph.hxx"
+#include "kernels.hxx"
+#include "output.hxx"
+#include "ranks.hxx"
+#include "solver.hxx"
+
+using Error     = utility::Error;
+using ErrorCode = utility::Error::ErrorCode;
+using Graph     = utility::Graph;
+
+namespace kernels = exe::kernels;
+
+#ifdef PAGERANK_MPI
+
+// --- TYPES --- //
+
+/// MPI for the length of a run. Only the main thread ever calls into it
+class Session {
+  private:
+    int rank{ 0 };
+    int size{ 1 };
+
+  public:
+    Session();
+    ~Session();
+
+    Session(const Session&) = delete;
+    auto operator=(const Session&) -> Session& = delete;
+
+    inline auto get_rank() const -> uint32_t {
+      return static_cast<uint32_t>(this->rank);
+    }
+
+    inline auto get_size() const -> uint32_t {
+      return static_cast<uint32_t>(this->size);
+    }
+};
+
+/// The rows of a process, with every link renumbered into its local vector of scaled ranks:
+/// its own nodes, and then the ghosts, sorted. The links of every row keep their order, so
+/// every row is summed up in the same order as in the whole graph
+struct Part {
+  /// How many nodes and links the whole graph has
+  uint32_t              nodes{ 0 };
+  uint64_t              edges{ 0 };
+  /// The rows of the process are `[first, first + rows)`
+  uint32_t              first{ 0 };
+  uint32_t              rows{ 0 };
+  /// How long the local vector is, the own nodes and the ghosts
+  uint32_t              locals{ 0 };
+  /// Where the rows of every process start, with the end of the last one. Has `size + 1` entries
+  std::vector<uint32_t> owners{};
+  /// Where every thread's rows start, counting from `first`. Has `threads + 1` entries
+  std::vector<uint32_t> blocks{};
+  /// The rows, with local sources and normalized weights
+  utility::Rows         matrix{};
+  /// The rows whose links all come from the process itself, and the rest
+  std::vector<uint32_t> interior{};
+  std::vector<uint32_t> boundary{};
+  /// Which own nodes go to every process, grouped by process, and where its ghosts land
+  std::vector<uint32_t> send_nodes{};
+  std::vector<int>      send_counts{};
+  std::vector<int>      send_displs{};
+  std::vector<int>      recv_counts{};
+  std::vector<int>      recv_displs{};
+};
+
+// --- CONSTANTS --- //
+
+/// How many interior rows a thread sums up before the main thread checks on the exchange again
+constexpr uint32_t interior_chunk_gc{ 1024 };
+/// How many boundary rows a thread takes at a time
+constexpr uint32_t boundary_chunk_gc{ 256 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+/// Throw for every option the distributed solver does not support
+static auto check_options(const utility::Options&) -> void;
+
+/// Everything a process does in a run, from loading its rows to writing its ranks
+static auto run(
+  const Session& session,
+  const utility::Options&) -> void;
+
+/// Load or generate the rows of process `rank` out of `size`, and only those
+static auto load_part(
+  const utility::Options&,
+  const uint32_t rank,
+  const uint32_t size) -> Part;
+
+/// Split the rows of `links` the way `Graph::partition` does, in `size*threads` parts, with
+/// every process only counting the links into an even share of the rows
+static auto split_rows(
+  const utility::LinkFile& links,
+  const uint32_t rank,
+  const uint32_t size,
+  const uint32_t threads) -> std::vector<uint32_t>;
+
+/// Find the ghosts of `rows`, the rows of process `rank` out of `size`, which are blocks
+/// `[rank*threads, (rank + 1)*threads)` of `bounds`, and agree with the other processes
+/// on who sends what to whom
+static auto make_part(
+  utility::Rows rows,
+  const uint32_t nodes,
+  const std::vector<uint32_t>& bounds,
+  const uint32_t rank,
+  const uint32_t size,
+  const uint32_t threads) -> Part;
+
+/// Gather the sums of every block of every process, and combine them in block order
+static auto reduce(const std::vector<kernels::Partial>& partials) -> kernels::Partial;
+
+/// Run the power method on the rows of `part`, and return the normalized ranks of those rows only
+static auto solve(
+  const Part& part,
+  const utility::Options&,
+  const std::span<const double> teleport) -> exe::Solution;
+
+/// Write the ranks of every process where `--output`, `--top-k` and `--save-ranks` say, the same
+/// as a single process would, without any process ever holding more than the ranks of one process
+static auto write_ranks(
+  const Part& part,
+  const exe::Solution& local,
+  const utility::Options&) -> void;
+
+/// Write the `count` elements of `data` of every process to `file` at `at`, all processes at once
+static auto write_at(
+  const MPI_File file,
+  const uint64_t at,
+  const void* data,
+  const uint64_t count,
+  const MPI_Datatype type) -> bool;
+
+// --- FUNCTION DEFINITIONS --- //
+
+Session::Session() {
+  int provided{ 0 };
+  MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided);
+
+  // the threads of a process never call into MPI, but they have to be there while it runs
+  if (provided < MPI_THREAD_FUNNELED) {
+    MPI_Finalize();
+    throw Error{ "", ErrorCode::MPI_THREAD_ERR };
+  }
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &this->rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &this->size);
+}
+
+Session::~Session() {
+  MPI_Finalize();
+}
+
+auto exe::pagerank_distributed(const utility::Options& options) -> void {
+  check_options(options);
+
+  const Session session{};
+  try {
+    run(session, options);
+  } catch (const Error& err) {
+    if (session.get_size() == 1) throw;
+
+    // the other processes would wait on this one forever
+    std::cerr << "\x1b[31mERROR!! Process " << session.get_rank() << " failed with error "
+              << static_cast<int>(err.error) << " (" << err.erroneous << "), aborting all of them!\n";
+    MPI_Abort(MPI_COMM_WORLD, static_cast<int>(err.error));
+  }
+}
+
+static auto check_options(const utility::Options& options) -> void {
+  if (!options.batch_path.empty()) throw Error{ "--batch", ErrorCode::DISTRIBUTED_ERR };
+  if (options.method != utility::Method::POWER) throw Error{ "--method", ErrorCode::DISTRIBUTED_ERR };
+  if (options.precision != utility::Precision::DOUBLE) throw Error{ "--precision", ErrorCode::DISTRIBUTED_ERR };
+  if (options.block_nodes != 0 || options.block_auto) throw Error{ "--block", ErrorCode::DISTRIBUTED_ERR };
+  if (options.reorder != utility::Reorder::NONE) throw Error{ "--reorder", ErrorCode::DISTRIBUTED_ERR };
+  if (!options.delta_path.empty()) throw Error{ "--delta", ErrorCode::DISTRIBUTED_ERR };
+  if (!options.warm_path.empty() || options.push) throw Error{ "--warm-start", ErrorCode::DISTRIBUTED_ERR };
+  if (!options.checkpoint_path.empty()) throw Error{ "--checkpoint", ErrorCode::DISTRIBUTED_ERR };
+  if (!options.resume_path.empty()) throw Error{ "--resume", ErrorCode::DISTRIBUTED_ERR };
+  if (options.bind != utility::Bind::NONE) throw Error{ "--bind", ErrorCode::DISTRIBUTED_ERR };
+  if (options.profile) throw Error{ "--profile", ErrorCode::DISTRIBUTED_ERR };
+}
+
+static auto run(
+  const Session& session,
+  const utility::Options& options) -> void {
+  const auto rank{ session.get_rank() };
+  const auto size{ session.get_size() };
+  const auto root{ rank == 0 };
+
+  const auto part{ load_part(options, rank, size) };
+  const auto teleport{ options.personalize_path.empty()
+    ? std::vector<double>{}
+    : exe::load_teleport(options.personalize_path, part.nodes, part.first, part.first + part.rows) };
+
+  uint64_t counts[2]{ part.locals - part.rows, part.interior.size() };
+  uint64_t totals[2]{};
+  MPI_Reduce(counts, totals, 2, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  if (root) {
+    std::cout << R"(------ PAGERANK ------
+-> Iterations to run the algorithm for (at most): )" << options.iterations << R"(
+-> Tolerance: )" << options.tolerance << " (" << utility::norm_names_gc[static_cast<int>(options.norm)] << R"( norm)
+-> Dimensions of the transition matrix: )" << part.nodes << "x" << part.nodes << R"(
+-> Links in the graph: )" << part.edges << R"(
+-> Dumping factor: )" << options.dump_fac << R"(
+-> Method: power
+-> Teleportation: )" << (options.personalize_path.empty() ? std::string("uniform") : std::string(options.personalize_path)) << R"(
+-> Processes: )" << size << ", with " << options.jobs << R"( threads each
+-> Ghost ranks exchanged per iteration: )" << totals[0] << " (" << 100.0*static_cast<double>(totals[1])/part.nodes
+      << R"(% of the rows need none)
+----------------------
+)";
+  }
+
+  const auto local{ solve(part, options, teleport) };
+  write_ranks(part, local, options);
+
+  if (root) {
+    std::cout << "-> Iterations run: " << local.iterations
+              << "\n-> Final residual: " << local.residual << "\n";
+  }
+}
+
+static auto load_part(
+  const utility::Options& options,
+  const uint32_t rank,
+  const uint32_t size) -> Part {
+  const auto threads{ options.jobs };
+
+  // a binary graph file is only mapped, so every process only ever copies its own rows out of it
+  if (!options.graph_path.empty() && Graph::is_binary(options.graph_path)) {
+    const auto matrix{ Graph::load(options.graph_path, threads) };
+    if (matrix.get_nodes() < size) throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+
+    const auto bounds{ matrix.partition(size*threads) };
+    return make_part(
+      matrix.rows(bounds[rank*threads], bounds[(rank + 1)*threads]), matrix.get_nodes(), bounds, rank, size, threads);
+  }
+
+  // everything else is drawn or parsed again on every pass over it, and every
+  // process only keeps the links into its own rows, so no process holds the graph
+  const auto links{ options.graph_path.empty()
+    ? utility::LinkFile{
+      .source{ utility::generate_source(options.model, options.dims[0], options.degree, options.seed) },
+      .nodes{ options.dims[0] },
+      .weighted{ false } }
+    : Graph::open_edge_list(options.graph_path, threads) };
+  if (links.nodes < size) throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+
+  const auto bounds{ split_rows(links, rank, size, threads) };
+  return make_part(
+    Graph::rows_of(links.source, bounds[rank*threads], bounds[(rank + 1)*threads], links.weighted, threads),
+    links.nodes, bounds, rank, size, threads);
+}
+
+static auto split_rows(
+  const utility::LinkFile& links,
+  const uint32_t rank,
+  const uint32_t size,
+  const uint32_t threads) -> std::vector<uint32_t> {
+  const uint64_t nodes{ links.nodes };
+  const auto parts{ size*threads };
+  const auto begin{ static_cast<uint32_t>(nodes*rank/size) };
+  const auto end{ static_cast<uint32_t>(nodes*(rank + 1)/size) };
+  const auto counts{ Graph::count_links(links.source, begin, end, threads) };
+
+  uint64_t mine{ 0 };
+  for (const auto count : counts) mine += count;
+  uint64_t before{ 0 };
+  uint64_t edges{ 0 };
+  MPI_Exscan(&mine, &before, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(&mine, &edges, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  // what the first process gets out of an exclusive scan is undefined
+  if (rank == 0) before = 0;
+
+  // the cost of the rows before row `i` is the links into them plus `i`, and part `t` starts at the first
+  // row that costs at least `total*t/parts`. Every process finds the starts within its share, and the
+  // ones before it, which may be further back in the share of another: the earliest of all is the one
+  const auto total{ edges + nodes };
+  std::vector<uint32_t> bounds(parts + 1, links.nodes);
+  bounds[0] = 0;
+
+  uint64_t cost{ before + begin };
+  uint32_t t{ 1 };
+  for (uint32_t i{ begin }; i < end; i++) {
+    while (t < parts && total*t/parts <= cost) bounds[t++] = i;
+    cost += counts[i - begin] + 1;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, bounds.data(), static_cast<int>(parts + 1), MPI_UINT32_T, MPI_MIN, MPI_COMM_WORLD);
+  return bounds;
+}
+
+static auto make_part(
+  utility::Rows rows,
+  const uint32_t nodes,
+  const std::vector<uint32_t>& bounds,
+  const uint32_t rank,
+  const uint32_t size,
+  const uint32_t threads) -> Part {
+  Part part{};
+  part.nodes = nodes;
+  part.first = rows.first;
+  part.rows = static_cast<uint32_t>(rows.degrees.size());
+  part.owners.resize(size + 1);
+  for (uint32_t p{ 0 }; p <= size; p++) part.owners[p] = bounds[p*threads];
+  part.blocks.resize(threads + 1);
+  for (uint32_t t{ 0 }; t <= threads; t++) part.blocks[t] = bounds[rank*threads + t] - part.first;
+
+  const uint64_t links{ rows.sources.size() };
+  MPI_Allreduce(&links, &part.edges, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+  const auto first{ part.first };
+  const auto last{ part.first + part.rows };
+
+  // the ghosts, sorted and without duplicates
+  std::vector<std::vector<uint32_t>> found(threads);
+  #pragma omp parallel num_threads(threads)
+  {
+    auto& mine{ found[omp_get_thread_num()] };
+    #pragma omp for schedule(dynamic, boundary_chunk_gc)
+    for (uint32_t i = 0; i < part.rows; i++) {
+      for (auto e{ rows.offsets[i] }; e < rows.offsets[i + 1]; e++) {
+        if (rows.sources[e] < first || rows.sources[e] >= last) mine.push_back(rows.sources[e]);
+      }
+    }
+    std::sort(mine.begin(), mine.end());
+    mine.erase(std::unique(mine.begin(), mine.end()), mine.end());
+  }
+  std::vector<uint32_t> ghosts{};
+  for (const auto& mine : found) ghosts.insert(ghosts.end(), mine.begin(), mine.end());
+  found.clear();
+  std::sort(ghosts.begin(), ghosts.end());
+  ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+
+  part.locals = static_cast<uint32_t>(ghosts.size()) + part.rows;
+
+  std::vector<uint8_t> inside(part.rows);
+  #pragma omp parallel for num_threads(threads) schedule(dynamic, boundary_chunk_gc)
+  for (uint32_t i = 0; i < part.rows; i++) {
+    bool own{ true };
+    for (auto e{ rows.offsets[i] }; e < rows.offsets[i + 1]; e++) {
+      const auto source{ rows.sources[e] };
+      if (source >= first && source < last) {
+        rows.sources[e] = source - first;
+        continue;
+      }
+
+      const auto ghost{ std::lower_bound(ghosts.begin(), ghosts.end(), source) - ghosts.begin() };
+      rows.sources[e] = part.rows + static_cast<uint32_t>(ghost);
+      own = false;
+    }
+    inside[i] = own;
+  }
+  for (uint32_t i{ 0 }; i < part.rows; i++) (inside[i] ? part.interior : part.boundary).push_back(i);
+
+  // the ghosts of every process are a consecutive run of `ghosts`, since they are sorted
+  std::vector<int> ghost_displs(size);
+  part.recv_counts.resize(size);
+  part.recv_displs.resize(size);
+  for (const auto ghost : ghosts) {
+    const auto owner{ std::upper_bound(part.owners.begin(), part.owners.end(), ghost) - part.owners.begin() - 1 };
+    part.recv_counts[owner]++;
+  }
+  for (uint32_t p{ 1 }; p < size; p++) ghost_displs[p] = ghost_displs[p - 1] + part.recv_counts[p - 1];
+  for (uint32_t p{ 0 }; p < size; p++) part.recv_displs[p] = static_cast<int>(part.rows) + ghost_displs[p];
+
+  // every process asks the owners for its ghosts, which then know what to send every iteration
+  part.send_counts.resize(size);
+  part.send_displs.resize(size);
+  MPI_Alltoall(part.recv_counts.data(), 1, MPI_INT, part.send_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+  for (uint32_t p{ 1 }; p < size; p++) part.send_displs[p] = part.send_displs[p - 1] + part.send_counts[p - 1];
+
+  part.send_nodes.resize(part.send_displs[size - 1] + part.send_counts[size - 1]);
+  MPI_Alltoallv(
+    ghosts.data(), part.recv_counts.data(), ghost_displs.data(), MPI_UINT32_T,
+    part.send_nodes.data(), part.send_counts.data(), part.send_displs.data(), MPI_UINT32_T,
+    MPI_COMM_WORLD);
+  for (auto& node : part.send_nodes) node -= first;
+
+  // weights that still need normalizing need the totals and the out-degrees of their sources,
+  // which the owners send along the same way as the ranks, once
+  if (!rows.totals.empty()) {
+    std::vector<double> outgoing(2*part.send_nodes.size());
+    for (size_t k{ 0 }; k < part.send_nodes.size(); k++) {
+      outgoing[2*k] = rows.totals[part.send_nodes[k]];
+      outgoing[2*k + 1] = rows.degrees[part.send_nodes[k]];
+    }
+
+    std::vector<int> send_counts(size);
+    std::vector<int> send_displs(size);
+    std::vector<int> recv_counts(size);
+    std::vector<int> recv_displs(size);
+    for (uint32_t p{ 0 }; p < size; p++) {
+      send_counts[p] = 2*part.send_counts[p];
+      send_displs[p] = 2*part.send_displs[p];
+      recv_counts[p] = 2*part.recv_counts[p];
+      recv_displs[p] = 2*ghost_displs[p];
+    }
+
+    std::vector<double> incoming(2*ghosts.size());
+    MPI_Alltoallv(
+      outgoing.data(), send_counts.data(), send_displs.data(), MPI_DOUBLE,
+      incoming.data(), recv_counts.data(), recv_displs.data(), MPI_DOUBLE,
+      MPI_COMM_WORLD);
+
+    #pragma omp parallel for num_threads(threads)
+    for (uint64_t e = 0; e < links; e++) {
+      const auto source{ rows.sources[e] };
+      const auto ghost{ 2*static_cast<uint64_t>(source - std::min(source, part.rows)) };
+      rows.weights[e] = source < part.rows
+        ? Graph::normalize(rows.weights[e], rows.totals[source], rows.degrees[source])
+        : Graph::normalize(rows.weights[e], incoming[ghost], static_cast<uint32_t>(incoming[ghost + 1]));
+    }
+    rows.totals = {};
+  }
+
+  part.matrix = std::move(rows);
+  return part;
+}
+
+static auto reduce(const std::vector<kernels::Partial>& partials) -> kernels::Partial {
+  static_assert(sizeof(kernels::Partial) == 4*sizeof(double));
+
+  int size{ 1 };
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  std::vector<kernels::Partial> all(partials.size()*size);
+  MPI_Allgather(
+    partials.data(), static_cast<int>(4*partials.size()), MPI_DOUBLE,
+    all.data(), static_cast<int>(4*partials.size()), MPI_DOUBLE,
+    MPI_COMM_WORLD);
+
+  return kernels::combine(all);
+}
+
+static auto solve(
+  const Part& part,
+  const utility::Options& options,
+  const std::span<const double> teleport) -> exe::Solution {
+  const auto threads{ options.jobs };
+
+  // the rows make up a matrix of their own, whose sources index the local vector, so
+  // that the kernels of the solvers sum up and finish every row the way they always do
+  const auto matrix{ Graph::view(part.matrix.offsets, part.matrix.sources, part.matrix.weights, part.matrix.degrees) };
+  auto step{ kernels::make_step(matrix, options, teleport) };
+  // the teleportation is uniform over the whole graph, not only over these rows
+  step.uniform = 1.0/static_cast<double>(part.nodes);
+
+  std::vector<double> ranks[2]{ std::vector<double>(part.rows), std::vector<double>(part.rows) };
+  std::vector<double> scaled[2]{ std::vector<double>(part.locals), std::vector<double>(part.locals) };
+  const auto iterate{ [&](const uint32_t k) -> kernels::Iterate {
+    return { ranks[k].data(), scaled[k].data() };
+  } };
+  std::vector<double> sums(part.rows);
+  std::vector<double> outgoing(part.send_nodes.size());
+  std::vector<kernels::Partial> partials(threads);
+  const auto chunks{ (static_cast<uint32_t>(part.interior.size()) + interior_chunk_gc - 1)/interior_chunk_gc };
+
+  exe::Solution solution{};
+  kernels::Partial total{};
+  uint32_t current{ 0 };
+  MPI_Request request{ MPI_REQUEST_NULL };
+  int arrived{ 0 };
+
+  #pragma omp parallel num_threads(threads)
+  {
+    const auto t{ static_cast<uint32_t>(omp_get_thread_num()) };
+    const auto begin{ part.blocks[t] };
+    const auto end{ part.blocks[t + 1] };
+
+    partials[t] = kernels::init_rows(matrix, begin, end, iterate(0), step, {});
+
+    #pragma omp barrier
+    #pragma omp master
+    {
+      total = reduce(partials);
+      step.coefficient = kernels::next_coefficient(step, total);
+    }
+    #pragma omp barrier
+
+    while (solution.iterations < options.iterations) {
+      const auto* const now{ scaled[current].data() };
+
+      #pragma omp for
+      for (size_t k = 0; k < part.send_nodes.size(); k++) outgoing[k] = now[part.send_nodes[k]];
+
+      // the ghosts land right in their slots, which nothing reads before they are all there
+      #pragma omp master
+      {
+        MPI_Ialltoallv(
+          outgoing.data(), part.send_counts.data(), part.send_displs.data(), MPI_DOUBLE,
+          scaled[current].data(), part.recv_counts.data(), part.recv_displs.data(), MPI_DOUBLE,
+          MPI_COMM_WORLD, &request);
+        arrived = 0;
+      }
+
+      #pragma omp for schedule(dynamic, 1) nowait
+      for (uint32_t c = 0; c < chunks; c++) {
+        const auto stop{ std::min<size_t>((c + 1)*static_cast<size_t>(interior_chunk_gc), part.interior.size()) };
+        for (auto k{ c*static_cast<size_t>(interior_chunk_gc) }; k < stop; k++) {
+          sums[part.interior[k]] = kernels::multiply_row(matrix, now, part.interior[k]);
+        }
+        // the exchange only moves on while MPI gets called
+        if (t == 0 && arrived == 0) MPI_Test(&request, &arrived, MPI_STATUS_IGNORE);
+      }
+
+      #pragma omp master
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      #pragma omp barrier
+
+      #pragma omp for schedule(dynamic, boundary_chunk_gc)
+      for (size_t k = 0; k < part.boundary.size(); k++) {
+        sums[part.boundary[k]] = kernels::multiply_row(matrix, now, part.boundary[k]);
+      }
+
+      // every thread finishes the rows of its own block, in order, the way the solvers do
+      kernels::Partial block{};
+      for (uint32_t i{ begin }; i < end; i++) {
+        kernels::finish_row<double>(matrix, i, sums[i], iterate(current), iterate(current ^ 1), step, block);
+      }
+      partials[t] = block;
+
+      #pragma omp barrier
+      #pragma omp master
+      {
+        total = reduce(partials);
+        step.coefficient = kernels::next_coefficient(step, total);
+        solution.residual = kernels::finish_residual(options.norm, total);
+        solution.iterations++;
+        current ^= 1;
+      }
+      #pragma omp barrier
+
+      if (solution.residual < options.tolerance) break;
+    }
+  }
+
+  solution.ranks = std::move(ranks[current]);
+  for (auto& rank : solution.ranks) rank /= total.mass;
+
+  return solution;
+}
+
+static auto write_ranks(
+  const Part& part,
+  const exe::Solution& local,
+  const utility::Options& options) -> void {
+  int rank{ 0 };
+  int size{ 1 };
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  const auto root{ rank == 0 };
+  const auto path{ options.output_path };
+
+  // a rank file holds every rank at a fixed place, so every process writes its own
+  if (!options.ranks_path.empty()) {
+    const auto temp_str{ std::string(options.ranks_path) + ".tmp" };
+    MPI_File file{};
+    if (MPI_File_open(MPI_COMM_WORLD, temp_str.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS)
+      throw Error{ options.ranks_path, ErrorCode::FILE_ERR };
+
+    utility::RankHeader header{};
+    header.iterations = local.iterations;
+    header.nodes = part.nodes;
+    header.residual = local.residual;
+
+    const auto at{ sizeof(utility::RankHeader) + static_cast<uint64_t>(part.first)*sizeof(double) };
+    bool written{ MPI_File_set_size(file, static_cast<MPI_Offset>(sizeof(header) + part.nodes*sizeof(double))) == MPI_SUCCESS };
+    if (root) written = written && MPI_File_write_at(file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    written = write_at(file, at, local.ranks.data(), local.ranks.size(), MPI_DOUBLE) && written;
+    written = MPI_File_close(&file) == MPI_SUCCESS && written;
+    if (!written) throw Error{ options.ranks_path, ErrorCode::FILE_ERR };
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (root && std::rename(temp_str.c_str(), std::string(options.ranks_path).c_str()) != 0)
+      throw Error{ options.ranks_path, ErrorCode::FILE_ERR };
+  }
+
+  // and so do raw ranks
+  const auto single{ path.ends_with(".f32") };
+  if (options.top_k == 0 && (path.ends_with(".f64") || single)) {
+    const auto path_str{ std::string(path) };
+    MPI_File file{};
+    if (MPI_File_open(MPI_COMM_WORLD, path_str.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS)
+      throw Error{ path, ErrorCode::FILE_ERR };
+
+    const auto width{ single ? sizeof(float) : sizeof(double) };
+    bool written{ MPI_File_set_size(file, static_cast<MPI_Offset>(part.nodes*width)) == MPI_SUCCESS };
+    if (single) {
+      const std::vector<float> narrow(local.ranks.begin(), local.ranks.end());
+      written = write_at(file, part.first*width, narrow.data(), narrow.size(), MPI_FLOAT) && written;
+    } else {
+      written = write_at(file, part.first*width, local.ranks.data(), local.ranks.size(), MPI_DOUBLE) && written;
+    }
+    written = MPI_File_close(&file) == MPI_SUCCESS && written;
+    if (!written) throw Error{ path, ErrorCode::FILE_ERR };
+
+    if (root) std::cout << "-> Ranks written to " << path << "\n";
+    return;
+  }
+
+  // text is written by the first process alone, which gets the ranks of one process after the other
+  std::ofstream file{};
+  if (root && !path.empty()) {
+    file.open(std::string(path));
+    if (!file) throw Error{ path, ErrorCode::FILE_ERR };
+  }
+  auto& out{ path.empty() ? std::cout : static_cast<std::ostream&>(file) };
+
+  if (options.top_k != 0) {
+    // the best of all are among the best of every process. Sorted by node, the candidates
+    // of all processes are too, so ties go to the lower node the same way as in one process
+    auto best{ utility::top_k(local.ranks, options.top_k, options.jobs) };
+    std::sort(best.begin(), best.end());
+    std::vector<uint32_t> nodes(best.size());
+    std::vector<double> ranks(best.size());
+    for (size_t k{ 0 }; k < best.size(); k++) {
+      nodes[k] = part.first + best[k];
+      ranks[k] = local.ranks[best[k]];
+    }
+
+    const auto count{ static_cast<int>(best.size()) };
+    std::vector<int> counts(root ? size : 0);
+    std::vector<int> displs(root ? size : 0);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    for (int p{ 1 }; p < static_cast<int>(counts.size()); p++) displs[p] = displs[p - 1] + counts[p - 1];
+
+    const auto gathered{ root ? displs[size - 1] + counts[size - 1] : 0 };
+    std::vector<uint32_t> all_nodes(gathered);
+    std::vector<double> all_ranks(gathered);
+    MPI_Gatherv(
+      nodes.data(), count, MPI_UINT32_T, all_nodes.data(), counts.data(), displs.data(), MPI_UINT32_T, 0, MPI_COMM_WORLD);
+    MPI_Gatherv(
+      ranks.data(), count, MPI_DOUBLE, all_ranks.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (!root) return;
+
+    // `utility::top_k` picks the same ones out of the candidates, in positions into them
+    const auto picked{ utility::top_k(all_ranks, options.top_k, 1) };
+    nodes.resize(picked.size());
+    ranks.resize(picked.size());
+    for (size_t k{ 0 }; k < picked.size(); k++) {
+      nodes[k] = all_nodes[picked[k]];
+      ranks[k] = all_ranks[picked[k]];
+    }
+    utility::write_nodes(out, ranks, nodes, !path.empty());
+  } else if (!root) {
+    MPI_Send(local.ranks.data(), static_cast<int>(local.ranks.size()), MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+    return;
+  } else {
+    utility::write_text(out, local.ranks, !path.empty(), options.jobs, part.first);
+
+    std::vector<double> ranks{};
+    for (int p{ 1 }; p < size; p++) {
+      ranks.resize(part.owners[p + 1] - part.owners[p]);
+      MPI_Recv(ranks.data(), static_cast<int>(ranks.size()), MPI_DOUBLE, p, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      utility::write_text(out, ranks, !path.empty(), options.jobs, part.owners[p]);
+    }
+  }
+
+  out.flush();
+  if (!out) throw Error{ path, ErrorCode::FILE_ERR };
+  if (!path.empty()) std::cout << "-> Ranks written to " << path << "\n";
+}
+
+static auto write_at(
+  const MPI_File file,
+  const uint64_t at,
+  const void* data,
+  const uint64_t count,
+  const MPI_Datatype type) -> bool {
+  return MPI_File_write_at_all(
+    file, static_cast<MPI_Offset>(at), data, static_cast<int>(count), type, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+}
+
+#else
+
+auto exe::pagerank_distributed(const utility::Options&) -> void {
+  throw Error{ "--distributed", ErrorCode::NO_MPI_ERR };
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _DISTRIBUTED_HXX_
+#define _DISTRIBUTED_HXX_
+
+#include "types.hxx"
+
+namespace exe {
+  /// `run` over the processes of an MPI job, with the rows of the graph split among them.
+  ///
+  /// Every process only ever builds its own rows of the graph and holds the ranks of those
+  /// rows, which it writes out itself or hands to the first process in turn. It only gets
+  /// the ranks of the nodes outside of them that its rows link from (the ghosts), from the
+  /// processes that own them. While those are on the way, the rows that need no ghosts are
+  /// already summed up. The per-block sums of every iteration are gathered on every process
+  /// and combined in block order, so the result is bit for bit that of the serial solver
+  /// with as many blocks as processes times `jobs`.
+  ///
+  /// Throws with `ErrorCode::NO_MPI_ERR` when built without MPI, and with `ErrorCode::MPI_THREAD_ERR`
+  /// when MPI can't run alongside threads. An error of a single process aborts all of them
+  auto pagerank_distributed(const utility::Options&) -> void;
+}
+
+#endif /* _DISTRIBUTED_HXX_ */
@@ -0,0 +1,218 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "generate.hxx"
+
+#include <bit>
+#include <functional>
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// Separate random streams for every use, so that no two draws share a counter
+enum Stream : uint64_t {
+    ER_FROM = 1,
+    ER_TO = 2,
+    RMAT = 3,
+    BA = 4,
+    PERMUTATION = 5,
+    RMAT_ATTEMPT = 6,
+};
+
+/// The Graph500 R-MAT probabilities of recursing into the top left, top right
+/// and bottom left quadrant. The bottom right one gets the rest (0.05)
+constexpr double rmat_a_gc{ 0.57 };
+constexpr double rmat_b_gc{ 0.19 };
+constexpr double rmat_c_gc{ 0.19 };
+
+/// How many Feistel rounds scramble the R-MAT node IDs
+constexpr uint32_t feistel_rounds_gc{ 4 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+/// The SplitMix64 finalizer
+static inline auto mix(uint64_t z) -> uint64_t {
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// 64 random bits, depending only on the seed, the stream and the counter
+static inline auto random_bits(
+    const uint64_t seed,
+    const uint64_t stream,
+    const uint64_t counter) -> uint64_t {
+    return mix(mix(seed + 0x9E3779B97F4A7C15ull*stream) ^ mix(counter + 0xD1B54A32D192ED03ull*stream));
+}
+
+/// Map 64 random bits to `[0, bound)`
+static inline auto uniform(
+    const uint64_t bits,
+    const uint64_t bound) -> uint64_t {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(bits)*bound) >> 64);
+}
+
+/// Map 64 random bits to `[0, 1)`
+static inline auto uniform_real(const uint64_t bits) -> double {
+    return static_cast<double>(bits >> 11)*0x1.0p-53;
+}
+
+/// A seeded permutation of `[0, nodes)`: a Feistel network over the smallest
+/// even power of two that fits `nodes`, walking the cycle until we land inside
+static auto permute(
+    const uint64_t seed,
+    const uint32_t nodes,
+    uint64_t node) -> uint32_t {
+    auto half_bits{ (std::bit_width(static_cast<uint64_t>(nodes - 1)) + 1)/2 };
+    if (half_bits == 0) half_bits = 1;
+    const uint64_t half_mask{ (1ull << half_bits) - 1 };
+
+    do {
+        auto left{ node >> half_bits };
+        auto right{ node & half_mask };
+        for (uint32_t round{ 0 }; round < feistel_rounds_gc; round++) {
+            const auto next{ left ^ (random_bits(seed, PERMUTATION, (right << 8) | round) & half_mask) };
+            left = right;
+            right = next;
+        }
+        node = (left << half_bits) | right;
+    } while (node >= nodes);
+
+    return static_cast<uint32_t>(node);
+}
+
+static auto erdos_renyi(
+    const uint64_t seed,
+    const uint32_t nodes,
+    const uint64_t e) -> Edge {
+    const auto from{ static_cast<uint32_t>(uniform(random_bits(seed, ER_FROM, e), nodes)) };
+    auto to{ static_cast<uint32_t>(uniform(random_bits(seed, ER_TO, e), nodes)) };
+    // no self-links, without touching the distribution of the other ends
+    if (nodes > 1 && to == from) to = (to + 1) % nodes;
+
+    return { from, to };
+}
+
+static auto rmat(
+    const uint64_t seed,
+    const uint32_t nodes,
+    const uint64_t e) -> Edge {
+    const auto scale{ std::bit_width(static_cast<uint64_t>(nodes - 1)) };
+
+    // ends falling outside of the graph (when `nodes` is not a power of two)
+    // are drawn again, from the next part of the stream of the link
+    for (uint64_t attempt{ 0 };; attempt++) {
+        // every attempt gets a stream of its own, so that however many there are, none repeats
+        // another. The level of a draw takes the low 6 bits of the counter, with the link above
+        const auto stream{ attempt == 0 ? RMAT : random_bits(seed, RMAT_ATTEMPT, attempt) };
+        uint64_t from{ 0 };
+        uint64_t to{ 0 };
+        for (int level{ 0 }; level < scale; level++) {
+            const auto p{ uniform_real(random_bits(seed, stream, (e << 6) | static_cast<uint64_t>(level))) };
+
+            from <<= 1;
+            to <<= 1;
+            if (p < rmat_a_gc) continue;
+            if (p < rmat_a_gc + rmat_b_gc) to |= 1;
+            else if (p < rmat_a_gc + rmat_b_gc + rmat_c_gc) from |= 1;
+            else {
+                from |= 1;
+                to |= 1;
+            }
+        }
+
+        if (from < nodes && to < nodes)
+            return { permute(seed, nodes, from), permute(seed, nodes, to) };
+    }
+}
+
+static auto barabasi_albert(
+    const uint64_t seed,
+    const uint32_t degree,
+    const uint64_t e) -> Edge {
+    const auto from{ static_cast<uint32_t>(e/degree) };
+
+    // link `e` either points at the source of a random older link, which is
+    // preferential attachment, or copies the target of a random older link,
+    // which we resolve the same way. Every step goes back in the link order,
+    // so this ends, and it usually does after a couple of steps
+    auto current{ e };
+    while (current != 0) {
+        const auto pick{ uniform(random_bits(seed, BA, current), 2*current) };
+        if (pick % 2 == 0) return { from, static_cast<uint32_t>((pick/2)/degree) };
+
+        current = pick/2;
+    }
+
+    return { from, 0 };
+}
+
+/// Link `e` of a graph drawn from `model`
+static auto draw(
+    const Model model,
+    const uint32_t nodes,
+    const uint32_t degree,
+    const uint64_t seed,
+    const uint64_t e) -> Edge {
+    switch (model) {
+        case Model::RMAT:
+            return rmat(seed, nodes, e);
+        case Model::BA:
+            return barabasi_albert(seed, degree, e);
+        default:
+            return erdos_renyi(seed, nodes, e);
+    }
+}
+
+auto utility::generate_links(
+    const Model model,
+    const uint32_t nodes,
+    const uint32_t degree,
+    const uint64_t seed,
+    const uint32_t threads) -> std::vector<EdgeList> {
+    const uint64_t edges{ static_cast<uint64_t>(nodes)*degree };
+    std::vector<EdgeList> parts(threads);
+
+    #pragma omp parallel for num_threads(threads) schedule(static, 1)
+    for (uint32_t t = 0; t < threads; t++) {
+        const auto begin{ edges*t/threads };
+        const auto end{ edges*(t + 1)/threads };
+
+        auto& links{ parts[t].edges };
+        links.reserve(end - begin);
+        for (auto e{ begin }; e < end; e++) links.push_back(draw(model, nodes, degree, seed, e));
+    }
+
+    return parts;
+}
+
+auto utility::generate_source(
+    const Model model,
+    const uint32_t nodes,
+    const uint32_t degree,
+    const uint64_t seed) -> LinkSource {
+    const uint64_t edges{ static_cast<uint64_t>(nodes)*degree };
+
+    return [=](const uint32_t part, const uint32_t parts, const std::function<void(const Edge&, const double)>& emit) {
+        const auto begin{ edges*part/parts };
+        const auto end{ edges*(part + 1)/parts };
+        for (auto e{ begin }; e < end; e++) emit(draw(model, nodes, degree, seed, e), 0.0);
+    };
+}
@@ -0,0 +1,58 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GENERATE_HXX_
+#define _GENERATE_HXX_
+
+#include <cstdint>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "types.hxx"
+
+namespace utility {
+  /// Generate the links of a random graph with `nodes` nodes and `nodes*degree` links.
+  ///
+  /// Every link is a pure function of the seed and its own index (a counter-based
+  /// random stream), so the links are split over `threads` threads and the
+  /// resulting graph is the same for any amount of threads:
+  ///  * `ER`: Erdős–Rényi G(n, m), both ends uniform
+  ///  * `RMAT`: R-MAT with the Graph500 parameters (a = 0.57, b = c = 0.19),
+  ///    with the node IDs scrambled by a seeded permutation
+  ///  * `BA`: Barabási–Albert preferential attachment, `degree` links per node,
+  ///    using the copy model so that every link can be resolved independently
+  auto generate_links(
+    const Model model,
+    const uint32_t nodes,
+    const uint32_t degree,
+    const uint64_t seed,
+    const uint32_t threads) -> std::vector<EdgeList>;
+
+  /// The links `generate_links` draws, drawn again on every pass instead of being kept,
+  /// so that `Graph::from_source` builds the matrix straight out of them
+  auto generate_source(
+    const Model model,
+    const uint32_t nodes,
+    const uint32_t degree,
+    const uint64_t seed) -> LinkSource;
+}
+
+#endif /* _GENERATE_HXX_ */
@@ -0,0 +1,864 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "types.hxx"
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// Every array of a binary graph file starts at a multiple of this
+constexpr uint64_t alignment_gc{ 64 };
+/// Set in the header of binary graph files that hold weights
+constexpr uint32_t weighted_flag_gc{ 1 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+/// Sort the links of every row by source, and then weight. The scatters that put them
+/// there are racy in their order, so this keeps the structure (and every sum over it)
+/// independent of the thread count
+static auto sort_rows(
+    const std::span<const uint64_t> offsets,
+    const std::span<uint32_t> sources,
+    const std::span<double> weights,
+    const uint32_t threads) -> void {
+    const auto rows{ static_cast<uint32_t>(offsets.size() - 1) };
+
+    #pragma omp parallel num_threads(threads)
+    {
+        std::vector<std::pair<uint32_t, double>> row{};
+
+        #pragma omp for schedule(dynamic, 1024)
+        for (uint32_t i = 0; i < rows; i++) {
+            const auto begin{ offsets[i] };
+            const auto end{ offsets[i + 1] };
+
+            if (weights.empty()) {
+                std::sort(sources.begin() + begin, sources.begin() + end);
+                continue;
+            }
+
+            row.clear();
+            for (auto e{ begin }; e < end; e++) {
+                row.emplace_back(sources[e], weights[e]);
+            }
+            std::sort(row.begin(), row.end());
+            for (auto e{ begin }; e < end; e++) {
+                sources[e] = row[e - begin].first;
+                weights[e] = row[e - begin].second;
+            }
+        }
+    }
+}
+
+auto Graph::from_edges(
+    const std::vector<EdgeList>& parts,
+    const uint32_t nodes,
+    const uint32_t threads) -> Graph {
+    bool weighted{ false };
+    for (const auto& part : parts) {
+        if (!part.weights.empty()) weighted = true;
+    }
+    for (const auto& part : parts) {
+        if (weighted && part.weights.size() != part.edges.size())
+            throw Error{ std::string_view(__FILE__), Error::ErrorCode::WRONG_DIMS_ERR };
+    }
+
+    const auto visit{ [&](const uint32_t p, const auto& emit) {
+        const auto& part{ parts[p] };
+        for (uint64_t k{ 0 }; k < part.edges.size(); k++) emit(part.edges[k], weighted ? part.weights[k] : 0.0);
+    } };
+
+    return Graph::build(static_cast<uint32_t>(parts.size()), visit, nodes, weighted, threads);
+}
+
+auto Graph::from_source(
+    const LinkSource& source,
+    const uint32_t nodes,
+    const bool weighted,
+    const uint32_t threads) -> Graph {
+    const auto visit{ [&](const uint32_t part, const auto& emit) { source(part, threads, emit); } };
+
+    return Graph::build(threads, visit, nodes, weighted, threads);
+}
+
+template <typename Visit>
+auto Graph::build(
+    const uint32_t parts,
+    const Visit& visit,
+    const uint32_t nodes,
+    const bool weighted,
+    const uint32_t threads) -> Graph {
+    Graph graph{};
+    graph.nodes = nodes;
+    graph.offsets_data.assign(static_cast<uint64_t>(nodes) + 1, 0);
+    graph.degrees_data.assign(nodes, 0);
+
+    // count the incoming and outgoing links of every node
+    bool out_of_bounds{ false };
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1) reduction(||: out_of_bounds)
+    for (uint32_t part = 0; part < parts; part++) {
+        visit(part, [&](const Edge& edge, const double) {
+            if (edge.from >= nodes || edge.to >= nodes) {
+                out_of_bounds = true;
+                return;
+            }
+
+            std::atomic_ref(graph.offsets_data[edge.to + 1]).fetch_add(1, std::memory_order_relaxed);
+            std::atomic_ref(graph.degrees_data[edge.from]).fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    if (out_of_bounds)
+        throw Error{ std::string_view(__FILE__), Error::ErrorCode::OUT_OF_BOUNDS_ERR };
+
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+        graph.offsets_data[i + 1] += graph.offsets_data[i];
+    }
+
+    const uint64_t edges{ graph.offsets_data[nodes] };
+    graph.sources_data.resize(edges);
+    if (weighted) graph.weights_data.resize(edges);
+
+    // scatter every link into the row of its destination
+    std::vector<uint64_t> cursor(graph.offsets_data.begin(), graph.offsets_data.end() - 1);
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t part = 0; part < parts; part++) {
+        visit(part, [&](const Edge& edge, const double weight) {
+            const auto slot{ std::atomic_ref(cursor[edge.to]).fetch_add(1, std::memory_order_relaxed) };
+
+            graph.sources_data[slot] = edge.from;
+            if (weighted) graph.weights_data[slot] = weight;
+        });
+    }
+
+    sort_rows(graph.offsets_data, graph.sources_data, graph.weights_data, threads);
+
+    if (!weighted) {
+        graph.bind_storage();
+        return graph;
+    }
+
+    // now we have to normalize the weights, so that the links leaving every
+    // node sum up to 1. The totals are accumulated in row order, so they do
+    // not depend on the thread count either
+    std::vector<double> total_out(nodes, 0.0);
+    for (uint64_t e{ 0 }; e < edges; e++) {
+        total_out[graph.sources_data[e]] += graph.weights_data[e];
+    }
+
+    #pragma omp parallel for num_threads(threads)
+    for (uint64_t e = 0; e < edges; e++) {
+        const auto source{ graph.sources_data[e] };
+        graph.weights_data[e] = Graph::normalize(graph.weights_data[e], total_out[source], graph.degrees_data[source]);
+    }
+
+    graph.bind_storage();
+    return graph;
+}
+
+auto Graph::count_links(
+    const LinkSource& source,
+    const uint32_t first,
+    const uint32_t last,
+    const uint32_t threads) -> std::vector<uint64_t> {
+    std::vector<uint64_t> counts(last - first, 0);
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t part = 0; part < threads; part++) {
+        source(part, threads, [&](const Edge& edge, const double) {
+            if (edge.to >= first && edge.to < last)
+                std::atomic_ref(counts[edge.to - first]).fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    return counts;
+}
+
+auto Graph::rows_of(
+    const LinkSource& source,
+    const uint32_t first,
+    const uint32_t last,
+    const bool weighted,
+    const uint32_t threads) -> Rows {
+    const auto own{ [&](const uint32_t node) { return node >= first && node < last; } };
+
+    Rows rows{};
+    rows.first = first;
+    rows.offsets.assign(static_cast<uint64_t>(last - first) + 1, 0);
+    rows.degrees.assign(last - first, 0);
+
+    // count the links into and out of every node of the rows
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t part = 0; part < threads; part++) {
+        source(part, threads, [&](const Edge& edge, const double) {
+            if (own(edge.to)) std::atomic_ref(rows.offsets[edge.to - first + 1]).fetch_add(1, std::memory_order_relaxed);
+            if (own(edge.from)) std::atomic_ref(rows.degrees[edge.from - first]).fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    for (uint32_t i{ 0 }; i < last - first; i++) {
+        rows.offsets[i + 1] += rows.offsets[i];
+    }
+
+    rows.sources.resize(rows.offsets.back());
+    if (weighted) rows.weights.resize(rows.offsets.back());
+
+    // scatter the links into their rows. The weights leaving the own nodes get added up
+    // afterwards, which needs them all in one place, since the links come from any row
+    struct Leaving {
+        uint32_t from{ 0 };
+        uint32_t to{ 0 };
+        double   weight{ 0.0 };
+
+        auto operator<=>(const Leaving&) const = default;
+    };
+    std::vector<std::vector<Leaving>> leaving(weighted ? threads : 0);
+    std::vector<uint64_t> cursor(rows.offsets.begin(), rows.offsets.end() - 1);
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t part = 0; part < threads; part++) {
+        source(part, threads, [&](const Edge& edge, const double weight) {
+            if (own(edge.to)) {
+                const auto slot{ std::atomic_ref(cursor[edge.to - first]).fetch_add(1, std::memory_order_relaxed) };
+                rows.sources[slot] = edge.from;
+                if (weighted) rows.weights[slot] = weight;
+            }
+            if (weighted && own(edge.from)) leaving[part].push_back({ edge.from, edge.to, weight });
+        });
+    }
+
+    sort_rows(rows.offsets, rows.sources, rows.weights, threads);
+    if (!weighted) return rows;
+
+    // `from_edges` adds up the weights leaving a node in row order, and within a row
+    // by weight, which is the order of the links sorted by target and then weight
+    std::vector<Leaving> links{};
+    for (auto& part : leaving) {
+        links.insert(links.end(), part.begin(), part.end());
+        part = {};
+    }
+    std::sort(links.begin(), links.end());
+
+    rows.totals.assign(last - first, 0.0);
+    for (const auto& link : links) rows.totals[link.from - first] += link.weight;
+
+    return rows;
+}
+
+auto Graph::rows(
+    const uint32_t first,
+    const uint32_t last) const -> Rows {
+    const auto begin{ this->offsets_view[first] };
+    const auto end{ this->offsets_view[last] };
+
+    Rows rows{};
+    rows.first = first;
+    rows.offsets.resize(static_cast<uint64_t>(last - first) + 1);
+    for (uint32_t i{ first }; i <= last; i++) rows.offsets[i - first] = this->offsets_view[i] - begin;
+    rows.sources.assign(this->sources_view.begin() + begin, this->sources_view.begin() + end);
+    if (this->is_weighted()) rows.weights.assign(this->weights_view.begin() + begin, this->weights_view.begin() + end);
+    rows.degrees.assign(this->degrees_view.begin() + first, this->degrees_view.begin() + last);
+
+    return rows;
+}
+
+auto Graph::view(
+    const std::span<const uint64_t> offsets,
+    const std::span<const uint32_t> sources,
+    const std::span<const double> weights,
+    const std::span<const uint32_t> degrees) -> Graph {
+    // only the sizes are checked, since anything more would read the whole graph
+    if (offsets.empty() || offsets.size() - 1 > std::numeric_limits<uint32_t>::max()
+        || degrees.size() != offsets.size() - 1 || offsets.front() != 0 || offsets.back() != sources.size()
+        || (!weights.empty() && weights.size() != sources.size())) {
+        throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+    }
+
+    Graph graph{};
+    graph.nodes = static_cast<uint32_t>(offsets.size() - 1);
+    graph.offsets_view = offsets;
+    graph.sources_view = sources;
+    graph.weights_view = weights;
+    graph.degrees_view = degrees;
+    return graph;
+}
+
+auto Graph::apply(
+    const Delta& delta,
+    const uint32_t threads) const -> Graph {
+    if (this->is_weighted()) throw Error{ "", Error::ErrorCode::WEIGHTED_ERR };
+
+    // the changes, grouped by destination and sorted the same way as the rows
+    const auto by_row{ [](const Edge& a, const Edge& b) {
+        return a.to != b.to ? a.to < b.to : a.from < b.from;
+    } };
+    auto added{ delta.added };
+    auto removed{ delta.removed };
+    std::sort(added.begin(), added.end(), by_row);
+    std::sort(removed.begin(), removed.end(), by_row);
+
+    uint32_t nodes{ this->nodes };
+    for (const auto& edge : added) nodes = std::max({ nodes, edge.from + 1, edge.to + 1 });
+
+    Graph graph{};
+    graph.nodes = nodes;
+    graph.offsets_data.assign(static_cast<uint64_t>(nodes) + 1, 0);
+    graph.degrees_data.assign(nodes, 0);
+    std::copy(this->degrees_view.begin(), this->degrees_view.end(), graph.degrees_data.begin());
+
+    // where the changes of every row start in `added` and `removed`
+    std::vector<uint64_t> added_at(static_cast<uint64_t>(nodes) + 1, 0);
+    std::vector<uint64_t> removed_at(static_cast<uint64_t>(nodes) + 1, 0);
+    for (const auto& edge : added) {
+        added_at[edge.to + 1]++;
+        graph.degrees_data[edge.from]++;
+    }
+    for (const auto& edge : removed) {
+        if (edge.to >= this->nodes || edge.from >= this->nodes || graph.degrees_data[edge.from] == 0)
+            throw Error{ "", Error::ErrorCode::MISSING_LINK_ERR };
+
+        removed_at[edge.to + 1]++;
+        graph.degrees_data[edge.from]--;
+    }
+
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+        added_at[i + 1] += added_at[i];
+        removed_at[i + 1] += removed_at[i];
+
+        const auto kept{ i < this->nodes ? this->offsets_view[i + 1] - this->offsets_view[i] : 0 };
+        graph.offsets_data[i + 1] = graph.offsets_data[i] + kept
+            + (added_at[i + 1] - added_at[i]) - (removed_at[i + 1] - removed_at[i]);
+    }
+
+    graph.sources_data.resize(graph.offsets_data[nodes]);
+
+    // every row is a merge of its old links, minus the removed ones, with the added
+    // ones. All three are sorted, and so is the result
+    bool missing{ false };
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1024) reduction(||: missing)
+    for (uint32_t i = 0; i < nodes; i++) {
+        auto old_e{ i < this->nodes ? this->offsets_view[i] : 0 };
+        const auto old_end{ i < this->nodes ? this->offsets_view[i + 1] : 0 };
+        auto add_e{ added_at[i] };
+        auto rem_e{ removed_at[i] };
+        auto out{ graph.offsets_data[i] };
+
+        while (old_e < old_end || add_e < added_at[i + 1]) {
+            const auto old_source{ old_e < old_end ? this->sources_view[old_e] : std::numeric_limits<uint32_t>::max() };
+
+            if (old_e < old_end && rem_e < removed_at[i + 1] && removed[rem_e].from == old_source) {
+                old_e++;
+                rem_e++;
+            } else if (add_e < added_at[i + 1] && (old_e == old_end || added[add_e].from <= old_source)) {
+                graph.sources_data[out++] = added[add_e++].from;
+            } else {
+                // a removed link that is not in the row would never get matched
+                if (rem_e < removed_at[i + 1] && removed[rem_e].from < old_source) {
+                    missing = true;
+                    break;
+                }
+                graph.sources_data[out++] = this->sources_view[old_e++];
+            }
+        }
+
+        if (rem_e != removed_at[i + 1]) missing = true;
+    }
+
+    if (missing) throw Error{ "", Error::ErrorCode::MISSING_LINK_ERR };
+
+    graph.bind_storage();
+    return graph;
+}
+
+auto Graph::permute(
+    const std::vector<uint32_t>& order,
+    const uint32_t threads) const -> Graph {
+    const auto nodes{ this->nodes };
+    if (order.size() != nodes) throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+
+    // the new label of every node
+    std::vector<uint32_t> labels(nodes);
+    #pragma omp parallel for num_threads(threads)
+    for (uint32_t p = 0; p < nodes; p++) {
+        labels[order[p]] = p;
+    }
+
+    Graph graph{};
+    graph.nodes = nodes;
+    graph.offsets_data.resize(static_cast<uint64_t>(nodes) + 1);
+    graph.degrees_data.resize(nodes);
+    graph.offsets_data[0] = 0;
+
+    #pragma omp parallel for num_threads(threads)
+    for (uint32_t p = 0; p < nodes; p++) {
+        graph.offsets_data[p + 1] = this->offsets_view[order[p] + 1] - this->offsets_view[order[p]];
+        graph.degrees_data[p] = this->degrees_view[order[p]];
+    }
+    for (uint32_t p{ 0 }; p < nodes; p++) graph.offsets_data[p + 1] += graph.offsets_data[p];
+
+    graph.sources_data.resize(this->get_edges());
+    if (this->is_weighted()) graph.weights_data.resize(this->get_edges());
+
+    #pragma omp parallel num_threads(threads)
+    {
+        // the links of a weighted row get sorted along with their weights
+        std::vector<std::pair<uint32_t, double>> row{};
+
+        #pragma omp for schedule(dynamic, 1024)
+        for (uint32_t p = 0; p < nodes; p++) {
+            const auto begin{ this->offsets_view[order[p]] };
+            const auto end{ this->offsets_view[order[p] + 1] };
+            const auto out{ graph.offsets_data[p] };
+
+            if (!this->is_weighted()) {
+                for (auto e{ begin }; e < end; e++) {
+                    graph.sources_data[out + (e - begin)] = labels[this->sources_view[e]];
+                }
+                std::sort(graph.sources_data.begin() + out, graph.sources_data.begin() + out + (end - begin));
+                continue;
+            }
+
+            row.clear();
+            for (auto e{ begin }; e < end; e++) row.emplace_back(labels[this->sources_view[e]], this->weights_view[e]);
+            std::sort(row.begin(), row.end());
+            for (size_t k{ 0 }; k < row.size(); k++) {
+                graph.sources_data[out + k] = row[k].first;
+                graph.weights_data[out + k] = row[k].second;
+            }
+        }
+    }
+
+    graph.bind_storage();
+    return graph;
+}
+
+auto Graph::partition(const uint32_t parts) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> bounds(parts + 1, this->nodes);
+    bounds[0] = 0;
+
+    // the cost of the rows before row `i` is `offsets[i] + i`, which only grows
+    const uint64_t total{ this->get_edges() + this->nodes };
+    for (uint32_t t{ 1 }; t < parts; t++) {
+        const uint64_t target{ total*t/parts };
+
+        uint32_t low{ bounds[t - 1] };
+        uint32_t high{ this->nodes };
+        while (low < high) {
+            const uint32_t mid{ low + (high - low)/2 };
+            if (this->offsets_view[mid] + mid < target) low = mid + 1;
+            else high = mid;
+        }
+        bounds[t] = low;
+    }
+
+    return bounds;
+}
+
+auto Graph::bind_storage() -> void {
+    this->offsets_view = this->offsets_data;
+    this->sources_view = this->sources_data;
+    this->weights_view = this->weights_data;
+    this->degrees_view = this->degrees_data;
+}
+
+MappedFile::MappedFile(const std::string_view path) {
+    const std::string path_str(path);
+
+    const int fd{ open(path_str.c_str(), O_RDONLY) };
+    if (fd < 0) throw Error{ path, Error::ErrorCode::FILE_ERR };
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw Error{ path, Error::ErrorCode::FILE_ERR };
+    }
+
+    this->size = static_cast<size_t>(info.st_size);
+    if (this->size == 0) {
+        close(fd);
+        return;
+    }
+
+    this->address = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (this->address == MAP_FAILED) {
+        this->address = nullptr;
+        throw Error{ path, Error::ErrorCode::FILE_ERR };
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (this->address != nullptr) munmap(this->address, this->size);
+}
+
+auto MappedFile::advise(const int advice) const -> void {
+    if (this->address != nullptr) madvise(this->address, this->size, advice);
+}
+
+/// Skip blanks (but not newlines)
+static inline auto skip_blanks(
+    const char* pos,
+    const char* end) -> const char* {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) pos++;
+    return pos;
+}
+
+/// Whether the file starts the way binary graph files do
+static auto has_magic(const MappedFile& file) -> bool {
+    const GraphHeader magic_header{};
+    return file.get_size() >= sizeof(GraphHeader)
+        && std::equal(magic_header.magic, magic_header.magic + 8, file.data());
+}
+
+/// Hand every link of the lines in `[begin, end)` to `emit`, along with its weight (0 if `weighted`
+/// is not set), and return whether they were all well formed
+template <typename Emit>
+static auto parse_chunk(
+    const char* begin,
+    const char* end,
+    const bool weighted,
+    const Emit& emit) -> bool {
+    auto pos{ begin };
+    while (pos < end) {
+        const auto line_end{ std::find(pos, end, '\n') };
+
+        pos = skip_blanks(pos, line_end);
+        if (pos == line_end || *pos == '#' || *pos == '%') {
+            pos = line_end + 1;
+            continue;
+        }
+
+        Edge edge{};
+        auto res{ std::from_chars(pos, line_end, edge.from) };
+        if (res.ec != std::errc{}) return false;
+
+        pos = skip_blanks(res.ptr, line_end);
+        res = std::from_chars(pos, line_end, edge.to);
+        if (res.ec != std::errc{} || pos == res.ptr) return false;
+        pos = skip_blanks(res.ptr, line_end);
+
+        double weight{ 0.0 };
+        if (weighted) {
+            const auto w_res{ std::from_chars(pos, line_end, weight) };
+            // `from_chars` reads `inf` and `nan` too, which no link can weigh
+            if (w_res.ec != std::errc{} || !std::isfinite(weight) || weight < 0.0) return false;
+        }
+
+        emit(edge, weight);
+        pos = line_end + 1;
+    }
+
+    return true;
+}
+
+/// Whether the first link of an edge list carries a weight, which says whether they all do
+static auto has_weights(
+    const char* pos,
+    const char* end) -> bool {
+    while (pos < end) {
+        const auto line_end{ std::find(pos, end, '\n') };
+        pos = skip_blanks(pos, line_end);
+        if (pos == line_end || *pos == '#' || *pos == '%') {
+            pos = line_end + 1;
+            continue;
+        }
+
+        uint32_t columns{ 0 };
+        while (pos < line_end) {
+            columns++;
+            while (pos < line_end && *pos != ' ' && *pos != '\t' && *pos != '\r') pos++;
+            pos = skip_blanks(pos, line_end);
+        }
+        return columns >= 3;
+    }
+
+    return false;
+}
+
+/// Where chunk `part` out of `parts` of the file starts: on the first line that starts in its share of the bytes
+static auto chunk_start(
+    const MappedFile& file,
+    const uint32_t part,
+    const uint32_t parts) -> const char* {
+    const char* const end{ file.data() + file.get_size() };
+    if (part == parts) return end;
+
+    auto pos{ file.data() + file.get_size()/parts*part };
+    if (pos != file.data() && pos < end && *(pos - 1) != '\n') {
+        pos = std::find(pos, end, '\n');
+        if (pos < end) pos++;
+    }
+
+    return pos;
+}
+
+auto Graph::load_delta(const std::string_view path) -> Delta {
+    const MappedFile file(path);
+    const char* pos{ file.data() };
+    const char* const end{ file.data() + file.get_size() };
+
+    Delta delta{};
+    while (pos < end) {
+        const auto line_end{ std::find(pos, end, '\n') };
+
+        pos = skip_blanks(pos, line_end);
+        if (pos == line_end || *pos == '#' || *pos == '%') {
+            pos = line_end + 1;
+            continue;
+        }
+
+        const auto sign{ *pos };
+        if (sign != '+' && sign != '-') throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+        Edge edge{};
+        pos = skip_blanks(pos + 1, line_end);
+        auto res{ std::from_chars(pos, line_end, edge.from) };
+        if (res.ec != std::errc{}) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+        pos = skip_blanks(res.ptr, line_end);
+        res = std::from_chars(pos, line_end, edge.to);
+        if (res.ec != std::errc{} || skip_blanks(res.ptr, line_end) != line_end)
+            throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+        // there would be one node more than the labels can count
+        if (edge.from == std::numeric_limits<uint32_t>::max() || edge.to == std::numeric_limits<uint32_t>::max())
+            throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+        (sign == '+' ? delta.added : delta.removed).push_back(edge);
+        pos = line_end + 1;
+    }
+
+    return delta;
+}
+
+auto Graph::load(
+    const std::string_view path,
+    const uint32_t threads) -> Graph {
+    const auto file{ std::make_shared<const MappedFile>(path) };
+    if (has_magic(*file)) return Graph::load_binary(file, path, threads);
+
+    return Graph::load_edge_list(file, path, threads);
+}
+
+auto Graph::load_edge_list(
+    const std::shared_ptr<const MappedFile>& file,
+    const std::string_view path,
+    const uint32_t threads) -> Graph {
+    // we only go through the file once, front to back
+    file->advise(MADV_SEQUENTIAL);
+    file->advise(MADV_WILLNEED);
+
+    // the first link tells us whether the list carries weights
+    const auto weighted{ has_weights(file->data(), file->data() + file->get_size()) };
+
+    std::vector<EdgeList> parts(threads);
+    uint32_t max_node{ 0 };
+    bool malformed{ false };
+
+    // every thread gets a chunk of the file, starting right after a newline
+    #pragma omp parallel for num_threads(threads) reduction(max: max_node) reduction(||: malformed)
+    for (uint32_t t = 0; t < threads; t++) {
+        const auto begin{ chunk_start(*file, t, threads) };
+        const auto end{ chunk_start(*file, t + 1, threads) };
+
+        // a rough guess of the size of a line, to avoid most of the reallocations
+        auto& part{ parts[t] };
+        part.edges.reserve(static_cast<size_t>(end - begin)/12);
+        const auto parsed{ parse_chunk(begin, end, weighted, [&](const Edge& edge, const double weight) {
+            part.edges.push_back(edge);
+            if (weighted) part.weights.push_back(weight);
+            max_node = std::max({ max_node, edge.from, edge.to });
+        }) };
+        if (!parsed) malformed = true;
+    }
+
+    if (malformed) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    uint64_t edges{ 0 };
+    for (const auto& part : parts) edges += part.edges.size();
+    if (edges == 0) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+    // there would be one node more than the labels can count
+    if (max_node == std::numeric_limits<uint32_t>::max()) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    return Graph::from_edges(parts, max_node + 1, threads);
+}
+
+auto Graph::open_edge_list(
+    const std::string_view path,
+    const uint32_t threads) -> LinkFile {
+    const auto file{ std::make_shared<const MappedFile>(path) };
+    file->advise(MADV_SEQUENTIAL);
+
+    LinkFile links{};
+    links.weighted = has_weights(file->data(), file->data() + file->get_size());
+
+    // a first pass only checks the links and finds the last node, without keeping any
+    uint64_t edges{ 0 };
+    uint32_t max_node{ 0 };
+    bool malformed{ false };
+
+    #pragma omp parallel for num_threads(threads) reduction(+: edges) reduction(max: max_node) reduction(||: malformed)
+    for (uint32_t t = 0; t < threads; t++) {
+        const auto parsed{ parse_chunk(
+            chunk_start(*file, t, threads), chunk_start(*file, t + 1, threads), links.weighted,
+            [&](const Edge& edge, const double) {
+                edges++;
+                max_node = std::max({ max_node, edge.from, edge.to });
+            }) };
+        if (!parsed) malformed = true;
+    }
+
+    if (malformed || edges == 0 || max_node == std::numeric_limits<uint32_t>::max())
+        throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    links.nodes = max_node + 1;
+    links.source = [file, weighted = links.weighted](
+        const uint32_t part,
+        const uint32_t parts,
+        const std::function<void(const Edge&, const double)>& emit) {
+        parse_chunk(chunk_start(*file, part, parts), chunk_start(*file, part + 1, parts), weighted, emit);
+    };
+
+    return links;
+}
+
+auto Graph::is_binary(const std::string_view path) -> bool {
+    return has_magic(MappedFile(path));
+}
+
+auto Graph::load_binary(
+    const std::shared_ptr<const MappedFile>& file,
+    const std::string_view path,
+    const uint32_t threads) -> Graph {
+    GraphHeader header{};
+    std::memcpy(&header, file->data(), sizeof(GraphHeader));
+
+    // dividing keeps a crafted count from wrapping the product around
+    const auto fits{ [&](const uint64_t at, const uint64_t count, const uint64_t size) {
+        return at % alignment_gc == 0 && at <= file->get_size() && count <= (file->get_size() - at)/size;
+    } };
+    if (header.version != GraphHeader{}.version
+        || header.nodes > std::numeric_limits<uint32_t>::max()
+        || header.edges > file->get_size()/sizeof(uint32_t)
+        || !fits(header.offsets_at, header.nodes + 1, sizeof(uint64_t))
+        || !fits(header.degrees_at, header.nodes, sizeof(uint32_t))
+        || !fits(header.sources_at, header.edges, sizeof(uint32_t))
+        || ((header.flags & weighted_flag_gc) && !fits(header.weights_at, header.edges, sizeof(double))))
+        throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    Graph graph{};
+    graph.mapping = file;
+    graph.nodes = static_cast<uint32_t>(header.nodes);
+    graph.offsets_view = { reinterpret_cast<const uint64_t*>(file->data() + header.offsets_at), header.nodes + 1 };
+    graph.degrees_view = { reinterpret_cast<const uint32_t*>(file->data() + header.degrees_at), header.nodes };
+    graph.sources_view = { reinterpret_cast<const uint32_t*>(file->data() + header.sources_at), header.edges };
+    if (header.flags & weighted_flag_gc)
+        graph.weights_view = { reinterpret_cast<const double*>(file->data() + header.weights_at), header.edges };
+
+    if (graph.offsets_view.front() != 0 || graph.offsets_view.back() != header.edges)
+        throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    // every row has to lie within the links, and every link has to come from a node,
+    // or the solvers would read out of bounds. The stored out-degrees have to be those
+    // of the links too, or the solvers would divide the rank of a node by 0
+    const auto offsets{ graph.offsets_view };
+    const auto sources{ graph.sources_view };
+    const auto degrees{ graph.degrees_view };
+    std::vector<uint32_t> counts(header.nodes, 0);
+    bool malformed{ false };
+    #pragma omp parallel num_threads(threads)
+    {
+        #pragma omp for reduction(||: malformed)
+        for (uint64_t i = 0; i < header.nodes; i++) {
+            if (offsets[i] > offsets[i + 1]) malformed = true;
+        }
+        #pragma omp for reduction(||: malformed)
+        for (uint64_t e = 0; e < header.edges; e++) {
+            if (sources[e] >= header.nodes) malformed = true;
+            else std::atomic_ref(counts[sources[e]]).fetch_add(1, std::memory_order_relaxed);
+        }
+        #pragma omp for reduction(||: malformed)
+        for (uint64_t i = 0; i < header.nodes; i++) {
+            if (counts[i] != degrees[i]) malformed = true;
+        }
+    }
+    if (malformed) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    return graph;
+}
+
+auto Graph::save(const std::string_view path) const -> void {
+    const auto align{ [](const uint64_t at) {
+        return (at + alignment_gc - 1)/alignment_gc*alignment_gc;
+    } };
+
+    GraphHeader header{};
+    header.flags = this->is_weighted() ? weighted_flag_gc : 0;
+    header.nodes = this->nodes;
+    header.edges = this->get_edges();
+    header.offsets_at = align(sizeof(GraphHeader));
+    header.degrees_at = align(header.offsets_at + this->offsets_view.size_bytes());
+    header.sources_at = align(header.degrees_at + this->degrees_view.size_bytes());
+    header.weights_at = this->is_weighted()
+        ? align(header.sources_at + this->sources_view.size_bytes())
+        : 0;
+
+    const std::string path_str(path);
+    std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(path_str.c_str(), "wb"), &std::fclose);
+    if (file == nullptr) throw Error{ path, Error::ErrorCode::FILE_ERR };
+
+    uint64_t written{ 0 };
+    const auto write_at{ [&](const uint64_t at, const void* data, const uint64_t size) {
+        static const char padding[alignment_gc]{};
+        if (std::fwrite(padding, 1, at - written, file.get()) != at - written
+            || std::fwrite(data, 1, size, file.get()) != size)
+            throw Error{ path, Error::ErrorCode::FILE_ERR };
+        written = at + size;
+    } };
+
+    write_at(0, &header, sizeof(GraphHeader));
+    write_at(header.offsets_at, this->offsets_view.data(), this->offsets_view.size_bytes());
+    write_at(header.degrees_at, this->degrees_view.data(), this->degrees_view.size_bytes());
+    write_at(header.sources_at, this->sources_view.data(), this->sources_view.size_bytes());
+    if (this->is_weighted())
+        write_at(header.weights_at, this->weights_view.data(), this->weights_view.size_bytes());
+
+    if (std::fflush(file.get()) != 0) throw Error{ path, Error::ErrorCode::FILE_ERR };
+}
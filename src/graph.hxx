@@ -0,0 +1,327 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GRAPH_HXX_
+#define _GRAPH_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+// --- TYPES --- //
+
+namespace utility {
+  /// A directed link `from -> to`
+  struct Edge {
+    uint32_t from{ 0 };
+    uint32_t to{ 0 };
+  };
+
+  /// A batch of edges, as produced by a single thread of a generator or a loader.
+  /// `weights` is either empty (unweighted graph) or has one entry per edge
+  struct EdgeList {
+    std::vector<Edge>   edges{};
+    std::vector<double> weights{};
+  };
+
+  /// Hands every link of part `part` out of `parts` to `emit`, along with its weight, which
+  /// unweighted graphs ignore. Every pass over the same part has to hand out the same links
+  using LinkSource = std::function<void(
+    const uint32_t part,
+    const uint32_t parts,
+    const std::function<void(const Edge&, const double)>& emit)>;
+
+  /// The links of an edge list file, read straight out of a mapping of it on every pass
+  struct LinkFile {
+    LinkSource source{};
+    /// One more than the highest node any link has
+    uint32_t   nodes{ 0 };
+    bool       weighted{ false };
+  };
+
+  /// Rows `[first, first + degrees.size())` of a transition matrix, without the rest of it.
+  /// They are laid out the same as in `Graph`, only counting from their first row and link.
+  /// The sources are nodes of the whole graph
+  struct Rows {
+    uint32_t              first{ 0 };
+    std::vector<uint64_t> offsets{};
+    std::vector<uint32_t> sources{};
+    /// Empty for unweighted graphs
+    std::vector<double>   weights{};
+    /// The out-degrees of the nodes of the rows
+    std::vector<uint32_t> degrees{};
+    /// What the weights leaving every node of the rows add up to, in the order `Graph::from_edges`
+    /// adds them up in. Only there when the weights still need to be normalized with them
+    std::vector<double>   totals{};
+  };
+
+  /// Links to add to and remove from a graph
+  struct Delta {
+    std::vector<Edge> added{};
+    std::vector<Edge> removed{};
+  };
+
+  /// A read-only memory mapping of a whole file
+  class MappedFile {
+    private:
+      void*  address{ nullptr };
+      size_t size{ 0 };
+
+    public:
+      MappedFile(const std::string_view path);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+      inline auto data() const -> const char* {
+        return static_cast<const char*>(this->address);
+      }
+
+      inline auto get_size() const -> size_t {
+        return this->size;
+      }
+
+      /// Pass an `madvise` hint for the whole mapping
+      auto advise(const int advice) const -> void;
+  };
+
+  /// Header of the binary graph format. Every array that follows it in the
+  /// file starts at a 64-byte aligned offset, so that the file can be mapped
+  /// and used as the CSR structure directly. All values are little endian
+  struct GraphHeader {
+    char     magic[8]{ 'P', 'R', 'G', 'R', 'A', 'P', 'H', '\0' };
+    uint32_t version{ 1 };
+    uint32_t flags{ 0 };
+    uint64_t nodes{ 0 };
+    uint64_t edges{ 0 };
+    /// Where every array starts, counting from the start of the file.
+    /// `weights_at` is 0 for unweighted graphs
+    uint64_t offsets_at{ 0 };
+    uint64_t degrees_at{ 0 };
+    uint64_t sources_at{ 0 };
+    uint64_t weights_at{ 0 };
+  };
+
+  static_assert(sizeof(GraphHeader) == 64);
+
+  /// Sparse transition matrix of a link graph.
+  ///
+  /// The matrix is kept as CSR over the *incoming* links of every node (which is
+  /// the CSC of the adjacency matrix), so that row `i` holds the nodes linking to `i`
+  /// and a PageRank step is a pull-based SpMV costing O(E).
+  ///
+  /// Unweighted graphs store no values at all; the transition probability of
+  /// an edge `j -> i` is then `1/out_degree[j]`. Weighted graphs store the
+  /// already normalized probability of every edge.
+  ///
+  /// The arrays either live on the heap or point straight into a mapped binary graph file
+  class Graph {
+    private:
+      std::vector<uint64_t>             offsets_data{};
+      std::vector<uint32_t>             sources_data{};
+      std::vector<double>               weights_data{};
+      std::vector<uint32_t>             degrees_data{};
+      std::shared_ptr<const MappedFile> mapping{};
+      //
+      std::span<const uint64_t>         offsets_view{};
+      std::span<const uint32_t>         sources_view{};
+      std::span<const double>           weights_view{};
+      std::span<const uint32_t>         degrees_view{};
+      uint32_t                          nodes{ 0 };
+
+      /// Point the views to the heap arrays
+      auto bind_storage() -> void;
+
+      /// Build the matrix out of the links `visit(part, emit)` hands to `emit`, for every part
+      /// of `parts`: one pass counts them, the next one puts them in place
+      template <typename Visit>
+      static auto build(
+        const uint32_t parts,
+        const Visit& visit,
+        const uint32_t nodes,
+        const bool weighted,
+        const uint32_t threads) -> Graph;
+
+      static auto load_edge_list(
+        const std::shared_ptr<const MappedFile>&,
+        const std::string_view path,
+        const uint32_t threads) -> Graph;
+      static auto load_binary(
+        const std::shared_ptr<const MappedFile>&,
+        const std::string_view path,
+        const uint32_t threads) -> Graph;
+
+    public:
+      Graph() = default;
+      Graph(Graph&&) = default;
+      auto operator=(Graph&&) -> Graph& = default;
+
+      // the views may point into the graph itself
+      Graph(const Graph&) = delete;
+      auto operator=(const Graph&) -> Graph& = delete;
+
+      /// Build the transition matrix of a graph with `nodes` nodes out of the
+      /// edge batches in `parts`, using `threads` threads
+      static auto from_edges(
+        const std::vector<EdgeList>& parts,
+        const uint32_t nodes,
+        const uint32_t threads) -> Graph;
+
+      /// Build the transition matrix of a graph with `nodes` nodes straight out of `source`,
+      /// split in `threads` parts, without holding the links anywhere else. `source` is
+      /// gone through twice, so its links are drawn again rather than kept
+      static auto from_source(
+        const LinkSource& source,
+        const uint32_t nodes,
+        const bool weighted,
+        const uint32_t threads) -> Graph;
+
+      /// How many links of `source`, split in `threads` parts, go into every one of rows `[first, last)`
+      static auto count_links(
+        const LinkSource& source,
+        const uint32_t first,
+        const uint32_t last,
+        const uint32_t threads) -> std::vector<uint64_t>;
+
+      /// Build rows `[first, last)` out of `source`, split in `threads` parts, which is gone through
+      /// twice. Only the links into the rows and the weights out of them are ever kept, so that
+      /// every process of a distributed run holds its own rows only. The weights are as `source`
+      /// gives them, with the totals that normalize them
+      static auto rows_of(
+        const LinkSource& source,
+        const uint32_t first,
+        const uint32_t last,
+        const bool weighted,
+        const uint32_t threads) -> Rows;
+
+      /// Check the edge list at `path` in one pass over it, with `threads` threads, and return its links
+      static auto open_edge_list(
+        const std::string_view path,
+        const uint32_t threads) -> LinkFile;
+
+      /// Whether `path` is a binary graph file rather than an edge list
+      static auto is_binary(const std::string_view path) -> bool;
+
+      /// The transition probability of a link weighing `weight`, out of a node whose links weigh
+      /// `total` over `degree` links. A node whose links all weigh 0 spreads its rank over them evenly
+      static inline auto normalize(
+        const double weight,
+        const double total,
+        const uint32_t degree) -> double {
+        return total > 0.0 ? weight/total : 1.0/static_cast<double>(degree);
+      }
+
+      /// Load a graph from `path`, which is either a binary graph file or a
+      /// whitespace separated edge list (SNAP format).
+      ///
+      /// Binary files are mapped and used in place, without any parsing or copying. Their
+      /// offsets, sources and out-degrees are checked once, in parallel, so that no row reads
+      /// out of bounds or divides by a degree of 0.
+      /// Edge lists are parsed straight out of a mapping of the file in `threads`
+      /// chunks. Lines starting with `#` or `%` are comments, and an optional third
+      /// column holds the weight of every link
+      static auto load(
+        const std::string_view path,
+        const uint32_t threads) -> Graph;
+
+      /// Wrap CSR arrays owned by someone else, without copying them, laid out the same as
+      /// `offsets()`, `sources()`, `weights()` and `out_degrees()`. They have to outlive the graph
+      static auto view(
+        const std::span<const uint64_t> offsets,
+        const std::span<const uint32_t> sources,
+        const std::span<const double> weights,
+        const std::span<const uint32_t> degrees) -> Graph;
+
+      /// Load a delta file, where every line is either `+ <from> <to>` or `- <from> <to>`.
+      /// Lines starting with `#` or `%` are comments
+      static auto load_delta(const std::string_view path) -> Delta;
+
+      /// Build a copy of the graph with the links of `delta` added and removed, using `threads`
+      /// threads. Links to nodes past the last one add nodes. Removing a link the graph does not
+      /// have is an error, and so is changing a weighted graph, whose original weights are gone
+      auto apply(
+        const Delta& delta,
+        const uint32_t threads) const -> Graph;
+
+      /// Build a copy of the graph with its nodes relabeled, using `threads` threads. Node
+      /// `order[p]` becomes node `p`, and every row stays sorted by source
+      auto permute(
+        const std::vector<uint32_t>& order,
+        const uint32_t threads) const -> Graph;
+
+      /// Split the rows in `parts` consecutive ranges of about the same cost,
+      /// counting both their links and the rows themselves. Range `t` is
+      /// `[bounds[t], bounds[t + 1])`
+      auto partition(const uint32_t parts) const -> std::vector<uint32_t>;
+
+      /// Copy rows `[first, last)` out of the graph, with their weights already normalized
+      auto rows(
+        const uint32_t first,
+        const uint32_t last) const -> Rows;
+
+      /// Write the graph in the binary graph format
+      auto save(const std::string_view path) const -> void;
+
+      inline auto get_nodes() const -> uint32_t {
+        return this->nodes;
+      }
+
+      inline auto get_edges() const -> uint64_t {
+        return this->sources_view.size();
+      }
+
+      inline auto is_weighted() const -> bool {
+        return !this->weights_view.empty();
+      }
+
+      /// Whether the arrays point into a mapped file
+      inline auto is_mapped() const -> bool {
+        return this->mapping != nullptr;
+      }
+
+      /// Where the incoming links of every node start in `sources()`. Has `nodes + 1` entries
+      inline auto offsets() const -> std::span<const uint64_t> {
+        return this->offsets_view;
+      }
+
+      /// The source node of every link, grouped by destination
+      inline auto sources() const -> std::span<const uint32_t> {
+        return this->sources_view;
+      }
+
+      /// The transition probability of every link. Empty for unweighted graphs
+      inline auto weights() const -> std::span<const double> {
+        return this->weights_view;
+      }
+
+      /// The amount of outgoing links of every node
+      inline auto out_degrees() const -> std::span<const uint32_t> {
+        return this->degrees_view;
+      }
+  };
+}
+
+#endif /* _GRAPH_HXX_ */
@@ -0,0 +1,295 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _KERNELS_HXX_
+#define _KERNELS_HXX_
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "segments.hxx"
+#include "types.hxx"
+
+// --- TYPES --- //
+
+/// The pieces the solvers of `solver.hxx` are made of, which the other solvers of the library
+/// drive their own sweeps with. Not part of its interface (see `library.hxx`)
+namespace exe::kernels {
+  /// A bfloat16: the upper half of a float, with its exponent and 7 bits of mantissa
+  struct Bf16 {
+    uint16_t bits{ 0 };
+  };
+
+  /// One iterate of the power method. Besides the ranks themselves, we keep
+  /// them divided by the out-degree of every node, which is what the SpMV reads.
+  /// The SpMV reads the scaled ranks once per link, so they may also be kept in a
+  /// narrower type, as `Step::precision` says
+  struct Iterate {
+    double* ranks{ nullptr };
+    double* scaled{ nullptr };
+    float*  scaled_float{ nullptr };
+    Bf16*   scaled_bf16{ nullptr };
+  };
+
+  /// What every row of a sweep needs besides the matrix
+  struct Step {
+    double               damping{ 0.0 };
+    /// What the teleportation vector gets multiplied with: the damped rank
+    /// of the dangling nodes, plus the teleportation itself
+    double               coefficient{ 0.0 };
+    std::span<const double> teleport{};
+    /// The entries of a uniform teleportation vector
+    double               uniform{ 0.0 };
+    utility::Norm        norm{ utility::Norm::L1 };
+    utility::Method      method{ utility::Method::POWER };
+    /// The links regrouped by source segments, when the power method sweeps in blocks
+    const utility::Segments* segments{ nullptr };
+    /// Where the blocked sweep adds up every row over the segments
+    double*              sums{ nullptr };
+    /// What the scaled ranks the power method gathers are kept in
+    utility::Precision   precision{ utility::Precision::DOUBLE };
+  };
+
+  /// The sums a sweep produces over a block of rows, all in one pass
+  struct Partial {
+    /// The residual, before the norm is finished
+    double sum{ 0.0 };
+    double peak{ 0.0 };
+    /// The rank of the dangling nodes of the new iterate
+    double dangling{ 0.0 };
+    /// The rank of all nodes of the new iterate
+    double mass{ 0.0 };
+  };
+}
+
+// --- FUNCTION DECLARATIONS --- //
+
+namespace exe::kernels {
+  /// An unweighted graph keeps its ranks divided by the out-degree of every node, which is
+  /// what the SpMV reads. Weighted ones keep them as they are, since their links carry the division
+  inline auto scale_entry(
+    const utility::Graph& trans_matrix,
+    const double value,
+    const uint32_t i) -> double;
+
+  /// The scaled ranks of `iterate`, kept as `Scaled`
+  template <typename Scaled>
+  inline auto scaled_of(const Iterate& iterate) -> Scaled*;
+
+  inline auto widen(const double value) -> double;
+  inline auto widen(const float value) -> double;
+  inline auto widen(const Bf16 value) -> double;
+
+  /// Round `value` to the nearest `Scaled`, ties to even
+  template <typename Scaled>
+  inline auto narrow(const double value) -> Scaled;
+
+  /// Add up the links of row `i`, in double precision whatever `Scaled` is
+  template <typename Scaled>
+  inline auto multiply_row(
+    const utility::Graph& trans_matrix,
+    const Scaled* scaled_vec,
+    const uint32_t i) -> double;
+
+  inline auto residual_term(
+    const utility::Norm norm,
+    const double diff) -> double;
+
+  /// Turn the sum over the links of row `i` into its rank in `next`, and add it up in `partial`
+  template <typename Scaled>
+  inline auto finish_row(
+    const utility::Graph& trans_matrix,
+    const uint32_t i,
+    const double sum,
+    const Iterate& current,
+    const Iterate& next,
+    const Step& step,
+    Partial& partial) -> void;
+
+  /// The residual out of the combined sums of a sweep
+  inline auto finish_residual(
+    const utility::Norm norm,
+    const Partial& partial) -> double;
+
+  /// What the teleportation vector gets multiplied with in the next sweep
+  inline auto next_coefficient(
+    const Step& step,
+    const Partial& total) -> double;
+
+  /// The step of `options` over `trans_matrix`, teleporting to `teleport` (uniformly if empty)
+  auto make_step(
+    const utility::Graph& trans_matrix,
+    const utility::Options& options,
+    const std::span<const double> teleport) -> Step;
+
+  /// Set rows `[begin, end)` of the first iterate to `initial`, or the teleportation vector
+  auto init_rows(
+    const utility::Graph& trans_matrix,
+    const uint32_t begin,
+    const uint32_t end,
+    const Iterate& first,
+    const Step& step,
+    const std::span<const double> initial) -> Partial;
+
+  /// Run a sweep of `step.method` over rows `[begin, end)`, which make up block `block`
+  auto sweep(
+    const utility::Graph& trans_matrix,
+    const uint32_t block,
+    const uint32_t begin,
+    const uint32_t end,
+    const Iterate& current,
+    const Iterate& next,
+    const Step& step) -> Partial;
+
+  /// Combine per-block sums, always in block order
+  auto combine(const std::vector<Partial>& partials) -> Partial;
+}
+
+// --- FUNCTION DEFINITIONS --- //
+
+namespace exe::kernels {
+  inline auto scale_entry(
+    const utility::Graph& trans_matrix,
+    const double value,
+    const uint32_t i) -> double {
+    if (trans_matrix.is_weighted()) return value;
+
+    // nodes without outgoing links never appear as a source,
+    // so what we store for them does not matter
+    const auto degree{ trans_matrix.out_degrees()[i] };
+    return degree == 0 ? 0.0 : value/static_cast<double>(degree);
+  }
+
+  template <typename Scaled>
+  inline auto scaled_of(const Iterate& iterate) -> Scaled* {
+    if constexpr (std::is_same_v<Scaled, float>) return iterate.scaled_float;
+    else if constexpr (std::is_same_v<Scaled, Bf16>) return iterate.scaled_bf16;
+    else return iterate.scaled;
+  }
+
+  inline auto widen(const double value) -> double {
+    return value;
+  }
+
+  inline auto widen(const float value) -> double {
+    return value;
+  }
+
+  inline auto widen(const Bf16 value) -> double {
+    return std::bit_cast<float>(static_cast<uint32_t>(value.bits) << 16);
+  }
+
+  template <typename Scaled>
+  inline auto narrow(const double value) -> Scaled {
+    if constexpr (std::is_same_v<Scaled, Bf16>) {
+      // the ranks are never NaN, so rounding the bits is all there is to it
+      const auto bits{ std::bit_cast<uint32_t>(static_cast<float>(value)) };
+      return { static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16) };
+    } else {
+      return static_cast<Scaled>(value);
+    }
+  }
+
+  template <typename Scaled>
+  inline auto multiply_row(
+    const utility::Graph& trans_matrix,
+    const Scaled* scaled_vec,
+    const uint32_t i) -> double {
+    const auto offsets{ trans_matrix.offsets() };
+    const auto sources{ trans_matrix.sources() };
+    const auto weights{ trans_matrix.weights() };
+
+    double sum{ 0.0 };
+    if (trans_matrix.is_weighted()) {
+      for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+        sum += weights[e]*widen(scaled_vec[sources[e]]);
+      }
+    } else {
+      for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+        sum += widen(scaled_vec[sources[e]]);
+      }
+    }
+
+    return sum;
+  }
+
+  inline auto residual_term(
+    const utility::Norm norm,
+    const double diff) -> double {
+    return norm == utility::Norm::L2 ? diff*diff : std::abs(diff);
+  }
+
+  template <typename Scaled>
+  inline auto finish_row(
+    const utility::Graph& trans_matrix,
+    const uint32_t i,
+    const double sum,
+    const Iterate& current,
+    const Iterate& next,
+    const Step& step,
+    Partial& partial) -> void {
+    const auto teleport{ step.teleport.empty() ? step.uniform : step.teleport[i] };
+    const auto value{ step.damping*sum + step.coefficient*teleport };
+    const auto diff{ value - current.ranks[i] };
+
+    next.ranks[i] = value;
+    // the next sweep only needs the ranks divided by the out-degrees,
+    // so we produce them right away instead of in a separate pass
+    scaled_of<Scaled>(next)[i] = narrow<Scaled>(scale_entry(trans_matrix, value, i));
+
+    partial.sum += residual_term(step.norm, diff);
+    partial.peak = std::max(partial.peak, std::abs(diff));
+    // and the same goes for the rank the next sweep has to hand out
+    if (trans_matrix.out_degrees()[i] == 0) partial.dangling += value;
+    partial.mass += value;
+  }
+
+  inline auto finish_residual(
+    const utility::Norm norm,
+    const Partial& partial) -> double {
+    switch (norm) {
+      case utility::Norm::L2:
+        return std::sqrt(partial.sum);
+      case utility::Norm::LINF:
+        return partial.peak;
+      default:
+        return partial.sum;
+    }
+  }
+
+  inline auto next_coefficient(
+    const Step& step,
+    const Partial& total) -> double {
+    // the in-place methods do not keep the rank summing up to 1 within a sweep, so the
+    // teleportation is scaled by the rank there is. This leaves the fixed point as is,
+    // and the solution is normalized at the end anyway
+    if (step.method != utility::Method::POWER) return step.damping*total.dangling + (1.0 - step.damping)*total.mass;
+    return step.damping*total.dangling + (1.0 - step.damping);
+  }
+}
+
+#endif /* _KERNELS_HXX_ */
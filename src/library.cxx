@@ -0,0 +1,171 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "library.hxx"
+
+#include <algorithm>
+
+#include "kernels.hxx"
+
+using Error     = utility::Error;
+using ErrorCode = utility::Error::ErrorCode;
+
+namespace kernels = exe::kernels;
+
+// --- CONSTANTS --- //
+
+/// How many links (and offsets) every task checks and counts when wrapping a graph
+constexpr uint64_t count_chunk_gc{ 1 << 16 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto pagerank::Graph::from_csr(
+  Pool& pool,
+  const std::span<const uint64_t> offsets,
+  const std::span<const uint32_t> sources,
+  const std::span<const double> weights,
+  const std::span<const uint32_t> degrees) -> Graph {
+  if (offsets.empty()) throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+  const auto nodes{ offsets.size() - 1 };
+
+  Graph graph{};
+  if (degrees.empty()) graph.degrees.resize(nodes);
+
+  // counting the out-degrees reads every source anyway, which is when they get checked, and
+  // the offsets get checked to never decrease along with them, so that no row reaches past its links
+  std::atomic<bool> out_of_bounds{ false };
+  const auto chunks{ static_cast<uint32_t>((std::max<uint64_t>(sources.size(), nodes) + count_chunk_gc - 1)/count_chunk_gc) };
+  pool.run(chunks, [&](const uint32_t chunk, const uint32_t) {
+    const auto last_row{ std::min<uint64_t>((chunk + 1)*count_chunk_gc, nodes) };
+    for (auto i{ chunk*count_chunk_gc }; i < last_row; i++) {
+      if (offsets[i] > offsets[i + 1]) out_of_bounds.store(true, std::memory_order_relaxed);
+    }
+
+    const auto end{ std::min<uint64_t>((chunk + 1)*count_chunk_gc, sources.size()) };
+    for (auto e{ chunk*count_chunk_gc }; e < end; e++) {
+      if (sources[e] >= nodes) {
+        out_of_bounds.store(true, std::memory_order_relaxed);
+        continue;
+      }
+      if (degrees.empty()) std::atomic_ref(graph.degrees[sources[e]]).fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  if (out_of_bounds.load()) throw Error{ "", ErrorCode::OUT_OF_BOUNDS_ERR };
+
+  graph.matrix = utility::Graph::view(offsets, sources, weights, degrees.empty() ? graph.degrees : degrees);
+  return graph;
+}
+
+pagerank::Solver::Solver(
+  Pool& pool,
+  const uint32_t blocks)
+  : pool{ pool },
+    blocks{ std::max(blocks, 1u) } {
+}
+
+auto pagerank::Solver::solve(
+  const Graph& graph,
+  const Request& request) -> Result {
+  const auto& trans_matrix{ graph.get_matrix() };
+  const auto nodes{ trans_matrix.get_nodes() };
+  if (request.damping >= 1 || request.damping <= 0) throw Error{ "", ErrorCode::BAD_DUMPING_FAC_ERR };
+  if (nodes == 0
+    || (!request.teleport.empty() && request.teleport.size() != nodes)
+    || (!request.initial.empty() && request.initial.size() != nodes)) {
+    throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+  }
+
+  const auto parts{ std::min(this->blocks, nodes) };
+  const auto bounds{ trans_matrix.partition(parts) };
+
+  // the sweeps are those of the power method of `exe::pagerank_serial`, with one block per task
+  utility::Options options{};
+  options.dump_fac = request.damping;
+  options.norm = request.norm;
+  auto step{ kernels::make_step(trans_matrix, options, request.teleport) };
+
+  // the buffers stay allocated from one solve to the next
+  for (uint32_t k{ 0 }; k < 2; k++) {
+    this->ranks[k].resize(nodes);
+    this->scaled[k].resize(nodes);
+  }
+  const auto iterate{ [&](const uint32_t k) -> kernels::Iterate {
+    return { this->ranks[k].data(), this->scaled[k].data() };
+  } };
+  std::vector<kernels::Partial> partials(parts);
+
+  this->pool.run(parts, [&](const uint32_t block, const uint32_t) {
+    partials[block] = kernels::init_rows(trans_matrix, bounds[block], bounds[block + 1], iterate(0), step, request.initial);
+  });
+  auto total{ kernels::combine(partials) };
+
+  // every task checks whether to stop before it starts, and the first one that
+  // does drops the whole sweep, leaving the last whole iterate as it was
+  std::atomic<bool> halted{ false };
+  const auto should_stop{ [&]() -> bool {
+    return (request.cancel != nullptr && request.cancel->load(std::memory_order_relaxed))
+      || Clock::now() >= request.deadline;
+  } };
+
+  Result result{};
+  uint32_t current{ 0 };
+  while (result.iterations < request.iterations) {
+    step.coefficient = kernels::next_coefficient(step, total);
+
+    this->pool.run(parts, [&](const uint32_t block, const uint32_t) {
+      if (halted.load(std::memory_order_relaxed)) return;
+      if (should_stop()) {
+        halted.store(true, std::memory_order_relaxed);
+        return;
+      }
+
+      partials[block] = kernels::sweep(
+        trans_matrix,
+        block, bounds[block], bounds[block + 1],
+        iterate(current),
+        iterate(current ^ 1),
+        step);
+    });
+
+    if (halted.load()) {
+      const auto cancelled{ request.cancel != nullptr && request.cancel->load() };
+      result.status = cancelled ? Status::CANCELLED : Status::DEADLINE;
+      break;
+    }
+
+    total = kernels::combine(partials);
+    current ^= 1;
+    result.residual = kernels::finish_residual(request.norm, total);
+    result.iterations++;
+
+    if (result.residual < request.tolerance) {
+      result.status = Status::CONVERGED;
+      break;
+    }
+  }
+
+  auto& final_ranks{ this->ranks[current] };
+  this->pool.run(parts, [&](const uint32_t block, const uint32_t) {
+    for (uint32_t i{ bounds[block] }; i < bounds[block + 1]; i++) final_ranks[i] /= total.mass;
+  });
+
+  result.ranks = final_ranks;
+  return result;
+}
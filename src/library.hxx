@@ -0,0 +1,154 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _LIBRARY_HXX_
+#define _LIBRARY_HXX_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "pool.hxx"
+#include "types.hxx"
+
+// --- TYPES --- //
+
+/// PageRank as a library, for callers that solve many times over graphs they already hold,
+/// such as a service. Nothing here prints, and nothing here starts threads per call:
+///
+///   pagerank::Pool pool{ threads };                        // once
+///   auto graph{ pagerank::Graph::from_csr(pool, offsets, sources, {}, {}) };
+///   pagerank::Solver solver{ pool, 64 };                   // once per calling thread
+///   const auto result{ solver.solve(graph, { .iterations{ 100 }, .tolerance{ 1e-10 } }) };
+///
+/// Errors are thrown as `utility::Error`, the same as everywhere else
+namespace pagerank {
+  using Pool  = utility::Pool;
+  using Clock = std::chrono::steady_clock;
+
+  /// A transition matrix over CSR arrays the caller owns, laid out the same as `utility::Graph`:
+  /// row `i` holds the sources of the links to `i`, and the weights (if any) are already normalized
+  class Graph {
+    private:
+      /// Only there if the caller gave no out-degrees
+      std::vector<uint32_t> degrees{};
+      utility::Graph        matrix{};
+
+    public:
+      Graph() = default;
+      Graph(Graph&&) = default;
+      auto operator=(Graph&&) -> Graph& = default;
+
+      /// Wrap the arrays without copying them, so they have to outlive the graph. The out-degrees are
+      /// counted on `pool` when `degrees` is empty. Every source is checked to be a node, and the
+      /// offsets to never decrease, once, here
+      static auto from_csr(
+        Pool& pool,
+        const std::span<const uint64_t> offsets,
+        const std::span<const uint32_t> sources,
+        const std::span<const double> weights,
+        const std::span<const uint32_t> degrees) -> Graph;
+
+      inline auto get_matrix() const -> const utility::Graph& {
+        return this->matrix;
+      }
+
+      inline auto get_nodes() const -> uint32_t {
+        return this->matrix.get_nodes();
+      }
+
+      inline auto get_edges() const -> uint64_t {
+        return this->matrix.get_edges();
+      }
+  };
+
+  /// How a solve ended
+  enum class Status : int {
+    /// The residual dropped below the tolerance
+    CONVERGED = 0,
+    /// All iterations ran
+    ITERATIONS = 1,
+    /// The cancellation flag got set
+    CANCELLED = 2,
+    /// The deadline passed
+    DEADLINE = 3,
+  };
+
+  /// What to solve for. The spans belong to the caller and are only read during the solve
+  struct Request {
+    double                   damping{ 0.85 };
+    uint32_t                 iterations{ 100 };
+    /// Stop as soon as the residual drops below this. 0 runs all `iterations`
+    double                   tolerance{ 0.0 };
+    utility::Norm            norm{ utility::Norm::L1 };
+    /// The teleportation vector, summing up to 1. Uniform when empty
+    std::span<const double>  teleport{};
+    /// The first iterate, summing up to 1. The teleportation vector when empty
+    std::span<const double>  initial{};
+    /// Stop at the next block of rows once this is set, from any thread
+    const std::atomic<bool>* cancel{ nullptr };
+    /// Stop at the next block of rows once this is past
+    Clock::time_point        deadline{ Clock::time_point::max() };
+  };
+
+  /// What a solve produced. A cancelled or late solve still has the ranks of its last whole iteration
+  struct Result {
+    /// Normalized to sum up to 1. Points into the solver, and stays valid until its next solve
+    std::span<const double> ranks{};
+    uint32_t                iterations{ 0 };
+    double                  residual{ 0.0 };
+    Status                  status{ Status::ITERATIONS };
+  };
+
+  /// Runs the power method on the threads of a pool, keeping its buffers from one solve to the next.
+  ///
+  /// The rows are split in `blocks` blocks, which the threads of the pool take on like any
+  /// other tasks, and the per-block sums are combined in block order. The result thus only
+  /// depends on `blocks` and not on the threads, and is bit for bit that of `pagerank_serial`
+  /// with as many `jobs`. More blocks than threads leave room to even out the load.
+  ///
+  /// A solver handles one solve at a time. Many solvers can share a pool
+  class Solver {
+    private:
+      Pool&                pool;
+      uint32_t             blocks{ 1 };
+      std::vector<double>  ranks[2]{};
+      std::vector<double>  scaled[2]{};
+
+    public:
+      Solver(
+        Pool& pool,
+        const uint32_t blocks);
+
+      Solver(const Solver&) = delete;
+      auto operator=(const Solver&) -> Solver& = delete;
+
+      auto solve(
+        const Graph& graph,
+        const Request& request) -> Result;
+  };
+}
+
+#endif /* _LIBRARY_HXX_ */
@@ -17,6 +17,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <iostream>
 #include <string_view>
 #include <vector>
@@ -55,7 +56,35 @@ const Arguments options_gc{
   {"--iter", "-i", 'i', ArgType::OPTION, "%u"},
   {"--dims", "-d", 'd', ArgType::OPTION, "%ux%u"},
   {"--jobs", "-j", 'j', ArgType::OPTION, "%u"},
+  {"--bind", "-A", 'A', ArgType::OPTION, "%s"},
   {"--dump", "-D", 'D', ArgType::OPTION, "%f"},
+  {"--tol", "-t", 't', ArgType::OPTION, "%f"},
+  {"--norm", "-N", 'N', ArgType::OPTION, "%s"},
+  {"--method", "-M", 'M', ArgType::OPTION, "%s"},
+  {"--block", "-L", 'L', ArgType::OPTION, "%s"},
+  {"--reorder", "-O", 'O', ArgType::OPTION, "%s"},
+  {"--precision", "-F", 'F', ArgType::OPTION, "%s"},
+  {"--graph", "-g", 'g', ArgType::OPTION, "%s"},
+  {"--personalize", "-p", 'v', ArgType::OPTION, "%s"},
+  {"--batch", "-B", 'B', ArgType::OPTION, "%s"},
+  {"--binary", "-b", 'b', ArgType::OPTION, "%s"},
+  {"--delta", "-x", 'x', ArgType::OPTION, "%s"},
+  {"--warm-start", "-w", 'w', ArgType::OPTION, "%s"},
+  {"--save-ranks", "-R", 'R', ArgType::OPTION, "%s"},
+  {"--output", "-o", 'o', ArgType::OPTION, "%s"},
+  {"--top-k", "-K", 'K', ArgType::OPTION, "%u"},
+  {"--push", "-u", 'u', ArgType::FLAG, ""},
+  {"--distributed", "-X", 'X', ArgType::FLAG, ""},
+  {"--checkpoint", "-c", 'c', ArgType::OPTION, "%s"},
+  {"--checkpoint-every", "-C", 'C', ArgType::OPTION, "%u"},
+  {"--resume", "-z", 'z', ArgType::OPTION, "%s"},
+  {"--model", "-m", 'm', ArgType::OPTION, "%s"},
+  {"--seed", "-s", 'e', ArgType::OPTION, "%lu"},
+  {"--degree", "-k", 'k', ArgType::OPTION, "%u"},
+  {"--tries", "-T", 'T', ArgType::OPTION, "%u"},
+  {"--save", "-S", 'S', ArgType::OPTION, "%s"},
+  {"--trace", "-r", 'r', ArgType::OPTION, "%s"},
+  {"--profile", "-P", 'P', ArgType::FLAG, ""},
   {"-fserial", "-fs", 's', ArgType::FLAG, ""},
   {"-fparallel", "-fp", 'p', ArgType::FLAG, ""},
 };
@@ -71,6 +100,7 @@ auto get_option(
                 const CMDLineParam,
                 const Arguments,
                 char&) -> char;
+auto split_list(const CMDLineParam) -> CMDLineParams;
 
 // Commands
 
@@ -96,8 +126,34 @@ auto main(int argc, char** argv) -> int {
         break;
       case ErrorCode::BAD_VALUE_ERR:
         std::cerr << "\x1b[31mERROR!! Value " << err.erroneous << " is badly formed or out of range!\n";
+        break;
       case ErrorCode::BAD_DUMPING_FAC_ERR:
         std::cerr << "\x1b[31mERROR!! Dumping factor needs to be between 0 and 1 (exclusive)!\n";
+        break;
+      case ErrorCode::WRONG_DIMS_ERR:
+        std::cerr << "\x1b[31mERROR!! The transition matrix needs to be square and non-empty!\n";
+        break;
+      case ErrorCode::FILE_ERR:
+        std::cerr << "\x1b[31mERROR!! Could not open file " << err.erroneous << "!\n";
+        break;
+      case ErrorCode::BAD_FILE_ERR:
+        std::cerr << "\x1b[31mERROR!! File " << err.erroneous << " is badly formed or empty!\n";
+        break;
+      case ErrorCode::WEIGHTED_ERR:
+        std::cerr << "\x1b[31mERROR!! The links of a weighted graph can't be changed, as only their normalized weights are kept!\n";
+        break;
+      case ErrorCode::MISSING_LINK_ERR:
+        std::cerr << "\x1b[31mERROR!! A link to remove is not in the graph!\n";
+        break;
+      case ErrorCode::NO_MPI_ERR:
+        std::cerr << "\x1b[31mERROR!! This build has no MPI, so " << err.erroneous << " is not available!\n";
+        break;
+      case ErrorCode::DISTRIBUTED_ERR:
+        std::cerr << "\x1b[31mERROR!! Option " << err.erroneous << " is not supported with --distributed!\n";
+        break;
+      case ErrorCode::MPI_THREAD_ERR:
+        std::cerr << "\x1b[31mERROR!! The MPI library can't run alongside threads, which --distributed needs!\n";
+        break;
       default:
         std::cerr << "\x1b[31mERROR!! ERROR!! ERROR!!\n";
     }
@@ -133,6 +189,18 @@ auto read_args(int argc, char** argv) -> utility::Options {
     } else if (arguments[1] == "run") {
       options.command_p= reinterpret_cast<void*>(exe::pagerank);
 
+      parse_options(arguments, options_gc, options);
+    } else if (arguments[1] == "bench") {
+      options.command_p= reinterpret_cast<void*>(exe::bench);
+
+      parse_options(arguments, options_gc, options);
+    } else if (arguments[1] == "generate") {
+      options.command_p= reinterpret_cast<void*>(exe::generate);
+
+      parse_options(arguments, options_gc, options);
+    } else if (arguments[1] == "convert") {
+      options.command_p= reinterpret_cast<void*>(exe::convert);
+
       parse_options(arguments, options_gc, options);
     } else {
       throw Error{ arguments[1], ErrorCode::WRONG_COMMAND_ERR };
@@ -172,24 +240,75 @@ auto parse_options(
       if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
       i++;
       break;
-    // amount of jobs
+    // amount of jobs. `bench` takes a comma separated list of them
     case 'j':
+      options.sweep_jobs.clear();
+      for (const auto item : split_list(value)) {
+        res = std::from_chars(
+                              item.begin(), item.end(),
+                              options.jobs);
+
+        if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.jobs == 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+        options.sweep_jobs.push_back(options.jobs);
+      }
+      options.jobs = options.sweep_jobs[0];
+      i++;
+      break;
+    // dimensions of the matrix. `bench` takes a comma separated list of them
+    case 'd':
+      options.sweep_dims.clear();
+      for (const auto item : split_list(value)) {
+        err = std::sscanf(
+                          item.data(),
+                          "%ux%u",
+                          &options.dims[0],
+                          &options.dims[1]);
+
+        if (err == EOF || err < 2) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+        options.sweep_dims.push_back({ options.dims[0], options.dims[1] });
+      }
+      options.dims[0] = options.sweep_dims[0][0];
+      options.dims[1] = options.sweep_dims[0][1];
+      i++;
+      break;
+    // the random graph model
+    case 'm':
+      if (value == "er") options.model = utility::Model::ER;
+      else if (value == "rmat") options.model = utility::Model::RMAT;
+      else if (value == "ba") options.model = utility::Model::BA;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // the seed of the random graph
+    case 'e':
       res = std::from_chars(
                             value.begin(), value.end(),
-                            options.jobs);
+                            options.seed);
 
       if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
       i++;
       break;
-    // dimensions of the matrix
-    case 'd':
-      err = std::sscanf(
-                        value.data(),
-                        "%ux%u",
-                        &options.dims[0],
-                        &options.dims[1]);
+    // the average amount of outgoing links of every node
+    case 'k':
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.degree);
+
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.degree == 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // amount of times to repeat every benchmark
+    case 'T':
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.tries);
 
-      if (err == EOF) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.tries == 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // where to save the benchmark results
+    case 'S':
+      options.save_path = value;
       i++;
       break;
     // the dumping factor
@@ -201,6 +320,155 @@ auto parse_options(
       if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
       i++;
       break;
+    // the tolerance to stop at
+    case 't':
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.tolerance);
+
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.tolerance < 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // the norm of the residual
+    case 'N':
+      if (value == "l1") options.norm = utility::Norm::L1;
+      else if (value == "l2") options.norm = utility::Norm::L2;
+      else if (value == "linf") options.norm = utility::Norm::LINF;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // how to pin the threads
+    case 'A':
+      if (value == "compact") options.bind = utility::Bind::COMPACT;
+      else if (value == "spread") options.bind = utility::Bind::SPREAD;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // how the solver updates the ranks
+    case 'M':
+      if (value == "power") options.method = utility::Method::POWER;
+      else if (value == "gauss-seidel") options.method = utility::Method::GAUSS_SEIDEL;
+      else if (value == "async") options.method = utility::Method::ASYNC;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // how many source nodes every segment of a blocked sweep spans
+    case 'L':
+      options.block_auto = value == "auto";
+      if (options.block_auto) {
+        i++;
+        break;
+      }
+
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.block_nodes);
+
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // how to relabel the nodes before solving
+    case 'O':
+      if (value == "degree") options.reorder = utility::Reorder::DEGREE;
+      else if (value == "rcm") options.reorder = utility::Reorder::RCM;
+      else if (value == "rabbit") options.reorder = utility::Reorder::RABBIT;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // what the gathered ranks are kept in
+    case 'F':
+      if (value == "double") options.precision = utility::Precision::DOUBLE;
+      else if (value == "float") options.precision = utility::Precision::FLOAT;
+      else if (value == "bf16") options.precision = utility::Precision::BF16;
+      else throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // the edge list to load the graph from
+    case 'g':
+      options.graph_path = value;
+      i++;
+      break;
+    // the teleportation vector
+    case 'v':
+      options.personalize_path = value;
+      i++;
+      break;
+    // the batch of teleportation vectors
+    case 'B':
+      options.batch_path = value;
+      i++;
+      break;
+    // the links to add and remove
+    case 'x':
+      options.delta_path = value;
+      i++;
+      break;
+    // the rank file to start from
+    case 'w':
+      options.warm_path = value;
+      i++;
+      break;
+    // the rank file to write
+    case 'R':
+      options.ranks_path = value;
+      i++;
+      break;
+    // where to write the ranks
+    case 'o':
+      options.output_path = value;
+      i++;
+      break;
+    // how many of the highest ranks to write
+    case 'K':
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.top_k);
+
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.top_k == 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // where to write checkpoints
+    case 'c':
+      options.checkpoint_path = value;
+      i++;
+      break;
+    // how often to write them
+    case 'C':
+      res = std::from_chars(
+                            value.begin(), value.end(),
+                            options.checkpoint_every);
+
+      if (res.ec == std::errc::invalid_argument || res.ec == std::errc::result_out_of_range || options.checkpoint_every == 0) throw Error{ value, ErrorCode::BAD_VALUE_ERR };
+      i++;
+      break;
+    // the checkpoint to carry on from
+    case 'z':
+      options.resume_path = value;
+      i++;
+      break;
+    // the binary graph file to write
+    case 'b':
+      options.binary_path = value;
+      i++;
+      break;
+    // where to write the trace of a profiled run
+    case 'r':
+      options.profile = true;
+      options.trace_path = value;
+      i++;
+      break;
+    // profile every phase of the run
+    case 'P':
+      options.profile = true;
+      break;
+    // refine the warm start with forward pushes
+    case 'u':
+      options.push = true;
+      break;
+    // split the rows over the processes of an MPI job
+    case 'X':
+      options.distributed = true;
+      break;
     // use serial implementation
     case 's':
       options.do_serial = true;
@@ -236,6 +504,21 @@ auto get_option(
   return '\0';
 }
 
+auto split_list(const CMDLineParam param) -> CMDLineParams {
+  CMDLineParams items{};
+
+  size_t begin{ 0 };
+  while (begin <= param.size()) {
+    const auto end{ std::min(param.find(',', begin), param.size()) };
+    if (end == begin) throw Error{ param, ErrorCode::BAD_VALUE_ERR };
+
+    items.push_back(param.substr(begin, end - begin));
+    begin = end + 1;
+  }
+
+  return items;
+}
+
 auto print_help(const utility::Options& options) -> void {
   std::cout << "\x1b[33m" <<
     R"(Parallel Systems Extracurricular Project -- Christoforos-Marios Mamaloukas -- Parallel Systems Postgraduate Course -- NKUA
@@ -245,20 +528,97 @@ USAGE: )" << options.appname << R"( <COMMAND> [(<OPTION> <VALUE>).. | <FLAG>..]
 --- AVAILABLE COMMANDS ---
 help: Print this message
 run: Execute PageRank
+convert: Convert a graph to the binary graph format, which `run` can load without any parsing
+generate: Generate a random graph in the binary graph format
+bench: Time both the serial and the parallel execution over a sweep of sizes and thread counts
                                     
 --- AVAILABLE OPTIONS ---
 -> [global]
   * --jobs <number> | -j <number> : The amount of threads to run the algo on
+  * --bind compact|spread | -A compact|spread : Pin every thread to a CPU, filling up one NUMA node after the other
+                                               or dealing them out to the nodes in turn. The rows of every thread
+                                               (graph and ranks) are then placed on its node, and `run` reports
+                                               where the threads and the pages ended up
 
 -> run
-  * --iter <number> | -n <number> : The amount of iterations to run the algorithm for
+  * --iter <number> | -n <number> : The amount of iterations to run the algorithm for. With `--tol`, the most iterations to run
+  * --tol <number> | -t <number> : Stop once the residual between two iterates drops below this
+  * --norm l1|l2|linf | -N l1|l2|linf : The norm to measure the residual with. Defaults to l1
+  * --method power|gauss-seidel|async | -M power|gauss-seidel|async : How to update the ranks. `gauss-seidel` and `async`
+                                       update them in place, so a sweep already uses the ranks it produced. `gauss-seidel`
+                                       does so within every block of `--jobs` rows and is deterministic, `async` across
+                                       all rows. Defaults to power. `--batch` always uses power
+  * --block auto|<number> | -L auto|<number> : Sweep through the links one segment of this many source nodes at a time,
+                                              so that the ranks every segment reads stay in the cache. `auto` sizes the
+                                              segments after the last level cache, and turns blocking off for graphs
+                                              that fit in it anyway. Only for the power method. Defaults to 0 (off)
+  * --reorder degree|rcm|rabbit | -O degree|rcm|rabbit : Relabel the nodes before solving, so that the ranks every row
+                                              gathers lie closer together: by decreasing out-degree, by reverse
+                                              Cuthill-McKee, or community by community (label propagation). The
+                                              output still uses the original labels, and the time it took is weighed
+                                              against the time it saves per iteration
+  * --precision double|float|bf16 | -F double|float|bf16 : Keep the ranks every link gathers in single precision or
+                                              bfloat16, which halves or quarters what a sweep reads for them, and
+                                              add them up in double precision. Once the residual gets down to their
+                                              rounding, the solver goes on in double precision. Only for the power
+                                              method. Defaults to double
   * --dims <number>x<number> | -d <number>x<number> : The dimensions of the matrix to generate
+  * --model er|rmat|ba | -m er|rmat|ba : The random graph model to generate with (Erdos-Renyi, R-MAT or
+                                         Barabasi-Albert). Defaults to er
+  * --seed <number> | -s <number> : The seed of the generated graph. The same seed gives the same graph for any `--jobs`
+  * --degree <number> | -k <number> : The average amount of outgoing links of every generated node. Defaults to 16
   * --dump <number> | -D : The dumping factor to use. Has to be between 0 and 1 (exclusive)
+  * --personalize <path> | -p <path> : Teleport to (and hand out the rank of nodes without links by) this vector
+                                       instead of uniformly. Every line holds a `<node> [weight]` pair
+  * --batch <path> | -B <path> : Solve for many teleportation vectors in one go. Every line is a seed set, the nodes
+                                 to teleport to separated by whitespace. Takes precedence over `--personalize`
+  * --graph <path> | -g <path> : Load the graph from a binary graph file or an edge list (SNAP format)
+                                 instead of generating one. Every line of an edge list holds a
+                                 `<from> <to> [weight]` link. `--dims` is ignored
+  * --delta <path> | -x <path> : Add and remove links before solving. Every line is either `+ <from> <to>` or
+                                 `- <from> <to>`. Only for unweighted graphs
+  * --warm-start <path> | -w <path> : Start from the ranks of a rank file (see `--save-ranks`), such as the ranks
+                                      of the graph before `--delta`
+  * --save-ranks <path> | -R <path> : Write the final ranks, along with the iterations and the residual, as a rank file
+  * --output <path> | -o <path> : Write the ranks to this file instead of the standard output. `.f64` and `.f32` files get
+                                  them as raw doubles or floats (the block of all vectors, by node, for `--batch`), and
+                                  any other file as text, with every rank exact to the last bit
+  * --top-k <number> | -K <number> : Only write the ranks of this many nodes, the highest ones first, always as text
+  * --checkpoint <path> | -c <path> : Write the ranks, the iterations and the residual as a rank file every
+                                     `--checkpoint-every` iterations, in the background
+  * --checkpoint-every <number> | -C <number> : How often to write a checkpoint. Defaults to every 10 iterations
+  * --resume <path> | -z <path> : Carry on from a checkpoint, counting the iterations behind it towards `--iter`
+  * --trace <path> | -r <path> : Profile the run (see `--profile`) and write a Chrome trace-event file
+                                 with one lane per thread
+
+-> generate (also takes `--dims`, `--model`, `--seed` and `--degree`)
+  * --binary <path> | -b <path> : Where to write the binary graph file
+
+-> convert
+  * --graph <path> | -g <path> : The graph to convert
+  * --delta <path> | -x <path> : Links to add to and remove from the graph while converting it
+  * --binary <path> | -b <path> : Where to write the binary graph file
+
+-> bench (also takes every option of run)
+  * --dims <number>x<number>[,...] : The dimensions of the matrices to benchmark
+  * --jobs <number>[,...] : The amounts of threads to benchmark the parallel execution with
+  * --tries <number> | -T <number> : How many times to repeat every benchmark
+  * --save <path> | -S <path> : Where to save the results. Saved as JSON if the path ends in `.json`, CSV otherwise
 
 --- AVAILABLE FLAGS ---
 -> run
   * -fserial | -fs : Run the serial execution
   * -fparallel | -fp : Run the parallel execution
+  * --profile | -P : Time every phase of the run and, on Linux, read its cycles, instructions, LLC and dTLB misses
+  * --push | -u : With `--warm-start`, push the residuals of the nodes the changes affected to their neighbors
+                  before sweeping over the whole graph
+  * --distributed | -X : Split the rows over the processes of an MPI job (`mpirun -n <processes> ... run --distributed`),
+                         every one with `--jobs` threads, exchanging only the ranks of the nodes other processes link
+                         from. Every process only keeps its own rows of the graph it loads (or generates) and their
+                         ranks. Raw rank files (`.f64`, `.f32`) and `--save-ranks` are written by all processes at
+                         once with MPI-IO, while text and `--top-k` output go through the first one. Only for the
+                         power method in double precision, without `--batch`, `--delta`, `--warm-start`,
+                         checkpoints, `--block`, `--reorder`, `--bind` or `--profile`
 )" << "\x1b[0m";
 
   return;
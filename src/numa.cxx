@@ -0,0 +1,323 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "numa.hxx"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <utility>
+
+#include <omp.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// Where the kernel lists the NUMA nodes
+constexpr const char* nodes_dir_gc{ "/sys/devices/system/node" };
+/// How many pages to hand to a single `move_pages` call
+constexpr size_t pages_per_call_gc{ 4096 };
+/// `MPOL_MF_MOVE` of <linux/mempolicy.h>: move the pages only we use
+constexpr int move_flag_gc{ 1 << 1 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+/// Parse a sysfs CPU list, such as `0-3,8-11`
+static auto parse_cpu_list(const std::string& list) -> std::vector<uint32_t> {
+    std::vector<uint32_t> cpus{};
+
+    const char* pos{ list.data() };
+    const char* const end{ list.data() + list.size() };
+    while (pos < end) {
+        uint32_t first{ 0 };
+        auto res{ std::from_chars(pos, end, first) };
+        if (res.ec != std::errc{}) break;
+
+        uint32_t last{ first };
+        pos = res.ptr;
+        if (pos < end && *pos == '-') {
+            res = std::from_chars(pos + 1, end, last);
+            if (res.ec != std::errc{}) break;
+            pos = res.ptr;
+        }
+
+        for (auto cpu{ first }; cpu <= last; cpu++) cpus.push_back(cpu);
+        if (pos < end && *pos == ',') pos++;
+        else break;
+    }
+
+    return cpus;
+}
+
+#ifdef __linux__
+/// Query (`nodes == nullptr`) or move the pages in `pages`, a chunk at a time
+static auto move_pages(
+    std::vector<void*>& pages,
+    const int* nodes,
+    std::vector<int>& status) -> bool {
+    status.assign(pages.size(), -ENOENT);
+
+    for (size_t first{ 0 }; first < pages.size(); first += pages_per_call_gc) {
+        const auto count{ std::min(pages_per_call_gc, pages.size() - first) };
+        if (syscall(
+            SYS_move_pages, 0, count,
+            pages.data() + first,
+            nodes == nullptr ? nullptr : nodes + first,
+            status.data() + first,
+            nodes == nullptr ? 0 : move_flag_gc) < 0)
+            return false;
+    }
+
+    return true;
+}
+#endif
+
+/// The start of every page that starts within `[begin, begin + bytes)`
+static auto pages_of(
+    const void* begin,
+    const size_t bytes) -> std::vector<void*> {
+    std::vector<void*> pages{};
+#ifdef __linux__
+    const auto page{ static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) };
+    const auto first{ (reinterpret_cast<uintptr_t>(begin) + page - 1)/page*page };
+    const auto end{ reinterpret_cast<uintptr_t>(begin) + bytes };
+
+    for (auto at{ first }; at < end; at += page) pages.push_back(reinterpret_cast<void*>(at));
+#else
+    (void) begin;
+    (void) bytes;
+#endif
+    return pages;
+}
+
+auto Numa::get() -> Numa& {
+    static Numa numa{};
+    return numa;
+}
+
+auto Numa::enable(
+    const Bind bind,
+    const uint32_t threads) -> void {
+    this->bind = bind;
+    if (bind == Bind::NONE) return;
+
+#ifdef __linux__
+    cpu_set_t allowed{};
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(cpu_set_t), &allowed);
+
+    // every `nodeN` directory lists the CPUs of node N
+    std::error_code error{};
+    for (const auto& entry : std::filesystem::directory_iterator(nodes_dir_gc, error)) {
+        const auto name{ entry.path().filename().string() };
+        uint32_t node{ 0 };
+        if (name.rfind("node", 0) != 0
+            || std::from_chars(name.data() + 4, name.data() + name.size(), node).ec != std::errc{})
+            continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list{};
+        std::getline(file, list);
+
+        if (this->node_cpus.size() <= node) this->node_cpus.resize(node + 1);
+        for (const auto cpu : parse_cpu_list(list)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) this->node_cpus[node].push_back(cpu);
+        }
+    }
+
+    // without sysfs, every CPU we may run on is on a single node
+    if (std::all_of(this->node_cpus.begin(), this->node_cpus.end(), [](const auto& cpus) { return cpus.empty(); })) {
+        this->node_cpus.assign(1, {});
+        for (uint32_t cpu{ 0 }; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) this->node_cpus[0].push_back(cpu);
+        }
+    }
+#else
+    this->node_cpus.assign(1, { 0 });
+#endif
+
+    // memory-only nodes get no threads
+    std::vector<uint32_t> nodes{};
+    std::vector<std::pair<uint32_t, uint32_t>> flat{};
+    for (uint32_t node{ 0 }; node < this->node_cpus.size(); node++) {
+        if (this->node_cpus[node].empty()) continue;
+
+        nodes.push_back(node);
+        for (const auto cpu : this->node_cpus[node]) flat.emplace_back(cpu, node);
+    }
+
+    this->thread_cpus.resize(threads);
+    this->thread_nodes.resize(threads);
+    for (uint32_t t{ 0 }; t < threads; t++) {
+        if (bind == Bind::COMPACT) {
+            std::tie(this->thread_cpus[t], this->thread_nodes[t]) = flat[t % flat.size()];
+        } else {
+            const auto node{ nodes[t % nodes.size()] };
+            const auto& cpus{ this->node_cpus[node] };
+
+            this->thread_cpus[t] = cpus[(t/nodes.size()) % cpus.size()];
+            this->thread_nodes[t] = node;
+        }
+    }
+
+#ifdef __linux__
+    // OpenMP keeps reusing these threads for teams of the same size, which
+    // is what the solvers use, so thread `t` stays on its CPU from now on
+    #pragma omp parallel num_threads(threads)
+    {
+        cpu_set_t set{};
+        CPU_ZERO(&set);
+        CPU_SET(this->thread_cpus[omp_get_thread_num()], &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+    }
+#endif
+}
+
+auto Numa::place(
+    const void* begin,
+    const size_t bytes,
+    const uint32_t thread) -> void {
+    if (!this->is_enabled() || bytes == 0) return;
+
+#ifdef __linux__
+    auto pages{ pages_of(begin, bytes) };
+    const std::vector<int> nodes(pages.size(), static_cast<int>(this->thread_nodes[thread % this->thread_nodes.size()]));
+    std::vector<int> status{};
+
+    if (!move_pages(pages, nodes.data(), status)) {
+        this->failed += pages.size();
+        return;
+    }
+    for (const auto result : status) {
+        if (result < 0) this->failed++;
+    }
+#else
+    (void) begin;
+    (void) thread;
+#endif
+}
+
+auto Numa::place_graph(
+    const Graph& graph,
+    const std::vector<uint32_t>& bounds) -> void {
+    if (!this->is_enabled()) return;
+
+    const auto offsets{ graph.offsets() };
+    const auto parts{ static_cast<uint32_t>(bounds.size() - 1) };
+
+    // the pages of a mapped graph file only get read in once touched, and then land
+    // on the node of the thread that touched them, so the owner of every slice does
+    #pragma omp parallel num_threads(parts)
+    {
+        const auto t{ static_cast<uint32_t>(omp_get_thread_num()) };
+        const auto touch{ [](const auto data, const size_t count) {
+            const auto step{ std::max<size_t>(1, static_cast<size_t>(sysconf(_SC_PAGESIZE))/sizeof(data[0])) };
+            for (size_t k{ 0 }; k < count; k += step) {
+                [[maybe_unused]] const volatile auto value{ data[k] };
+            }
+        } };
+
+        const auto first{ offsets[bounds[t]] };
+        const auto links{ offsets[bounds[t + 1]] - first };
+        touch(offsets.data() + bounds[t], bounds[t + 1] - bounds[t]);
+        touch(graph.out_degrees().data() + bounds[t], bounds[t + 1] - bounds[t]);
+        touch(graph.sources().data() + first, links);
+        if (graph.is_weighted()) touch(graph.weights().data() + first, links);
+    }
+
+    for (uint32_t t{ 0 }; t < parts; t++) {
+        const auto rows{ bounds[t + 1] - bounds[t] };
+        const auto first{ offsets[bounds[t]] };
+        const auto links{ offsets[bounds[t + 1]] - first };
+
+        this->place(offsets.data() + bounds[t], rows*sizeof(uint64_t), t);
+        this->place(graph.out_degrees().data() + bounds[t], rows*sizeof(uint32_t), t);
+        this->place(graph.sources().data() + first, links*sizeof(uint32_t), t);
+        if (graph.is_weighted()) this->place(graph.weights().data() + first, links*sizeof(double), t);
+    }
+}
+
+auto Numa::record(
+    std::string name,
+    const void* begin,
+    const size_t bytes) -> void {
+    if (!this->is_enabled() || bytes == 0) return;
+
+    Placement placement{
+        .name = std::move(name),
+        .pages = std::vector<uint64_t>(this->node_cpus.size()),
+    };
+
+#ifdef __linux__
+    auto pages{ pages_of(begin, bytes) };
+    std::vector<int> status{};
+
+    if (!move_pages(pages, nullptr, status)) {
+        placement.unplaced = pages.size();
+    } else {
+        for (const auto node : status) {
+            if (node >= 0 && static_cast<size_t>(node) < placement.pages.size()) placement.pages[node]++;
+            else placement.unplaced++;
+        }
+    }
+#else
+    (void) begin;
+    (void) bytes;
+#endif
+
+    this->placements.push_back(std::move(placement));
+}
+
+auto Numa::report(std::ostream& out) const -> void {
+    if (!this->is_enabled()) return;
+
+    out << "------ NUMA ------\n-> Binding: " << (this->bind == Bind::COMPACT ? "compact" : "spread")
+        << " over " << this->node_cpus.size() << " node(s)\n-> Threads:";
+    for (uint32_t t{ 0 }; t < this->thread_cpus.size(); t++) {
+        out << " " << t << ":cpu" << this->thread_cpus[t] << "/node" << this->thread_nodes[t];
+    }
+    out << "\n";
+
+    for (const auto& placement : this->placements) {
+        uint64_t total{ placement.unplaced };
+        for (const auto pages : placement.pages) total += pages;
+
+        out << "-> " << std::left << std::setw(12) << placement.name << std::right;
+        for (uint32_t node{ 0 }; node < placement.pages.size(); node++) {
+            out << " node" << node << " " << std::fixed << std::setprecision(1)
+                << (total == 0 ? 0.0 : 100.0*static_cast<double>(placement.pages[node])/static_cast<double>(total)) << "%";
+        }
+        if (placement.unplaced != 0) out << " (" << placement.unplaced << " pages not in memory)";
+        out << "\n";
+    }
+
+    if (this->failed != 0) out << "-> Pages that could not be moved: " << this->failed << "\n";
+    out << std::defaultfloat << std::setprecision(6) << "------------------\n";
+}
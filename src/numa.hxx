@@ -0,0 +1,105 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _NUMA_HXX_
+#define _NUMA_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "types.hxx"
+
+// --- TYPES --- //
+
+namespace utility {
+  /// Thread pinning and page placement over the NUMA nodes of the machine.
+  ///
+  /// Once enabled, thread `t` of every team of `threads` threads runs on a CPU of
+  /// its own, and the rows a solver gives thread `t` (its slice of the graph and
+  /// of the rank vectors) live on the node of that CPU. The nodes and their CPUs
+  /// come from sysfs, and pages are queried and moved with the `move_pages` system
+  /// call, so no libnuma is needed. Without sysfs, the machine is a single node.
+  ///
+  /// While disabled, every call returns right away
+  class Numa {
+    public:
+      // --- TYPES --- //
+      /// How many pages of a buffer every node holds
+      struct Placement {
+        std::string           name{};
+        std::vector<uint64_t> pages{};
+        /// Pages not backed by memory yet, or that could not be queried
+        uint64_t              unplaced{ 0 };
+      };
+
+    private:
+      // --- FIELDS --- //
+      Bind                     bind{ Bind::NONE };
+      /// The CPUs of every node, out of the ones we are allowed to run on
+      std::vector<std::vector<uint32_t>> node_cpus{};
+      /// The CPU and node of every thread
+      std::vector<uint32_t>    thread_cpus{};
+      std::vector<uint32_t>    thread_nodes{};
+      std::vector<Placement>   placements{};
+      /// Pages `place()` could not move
+      uint64_t                 failed{ 0 };
+
+      Numa() = default;
+
+    public:
+      static auto get() -> Numa&;
+
+      /// Read the topology, and pin every thread of a team of `threads` threads
+      auto enable(
+        const Bind bind,
+        const uint32_t threads) -> void;
+
+      inline auto is_enabled() const -> bool {
+        return this->bind != Bind::NONE;
+      }
+
+      /// Move the pages of `[begin, begin + bytes)` to the node of `thread`
+      auto place(
+        const void* begin,
+        const size_t bytes,
+        const uint32_t thread) -> void;
+
+      /// Move the rows `[bounds[t], bounds[t + 1])` of `graph` to the node of thread `t`
+      auto place_graph(
+        const Graph& graph,
+        const std::vector<uint32_t>& bounds) -> void;
+
+      /// Look up on which nodes the pages of `[begin, begin + bytes)` are, to report as `name`
+      auto record(
+        std::string name,
+        const void* begin,
+        const size_t bytes) -> void;
+
+      /// Print where every thread runs, and where every recorded buffer is
+      auto report(std::ostream&) const -> void;
+  };
+}
+
+#endif /* _NUMA_HXX_ */
@@ -0,0 +1,215 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "output.hxx"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <omp.h>
+
+#include "types.hxx"
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// How many nodes every thread formats in a round
+constexpr uint64_t round_nodes_gc{ 1 << 16 };
+/// The longest line of a rank: `x[`, the node, `] = `, the rank and the newline
+constexpr uint64_t line_bytes_gc{ 2 + 10 + 4 + 24 + 1 };
+/// How many ranks to convert to floats at a time
+constexpr uint64_t convert_chunk_gc{ 1 << 16 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+/// Format the line of node `i` at `pos`, and return where it ends
+static inline auto format_line(
+    char* pos,
+    const uint32_t i,
+    const double rank,
+    const bool exact) -> char*;
+
+// --- FUNCTION DEFINITIONS --- //
+
+static inline auto format_line(
+    char* pos,
+    const uint32_t i,
+    const double rank,
+    const bool exact) -> char* {
+    char* const end{ pos + line_bytes_gc };
+
+    std::memcpy(pos, "x[", 2);
+    pos = std::to_chars(pos + 2, end, i).ptr;
+    std::memcpy(pos, "] = ", 4);
+    pos = exact
+        ? std::to_chars(pos + 4, end, rank).ptr
+        : std::to_chars(pos + 4, end, rank, std::chars_format::general, 6).ptr;
+    *pos = '\n';
+
+    return pos + 1;
+}
+
+auto utility::write_text(
+    std::ostream& out,
+    const std::span<const double> ranks,
+    const bool exact,
+    const uint32_t threads,
+    const uint32_t first) -> void {
+    const uint64_t nodes{ ranks.size() };
+    std::vector<std::string> buffers(threads, std::string(round_nodes_gc*line_bytes_gc, '\0'));
+    std::vector<uint64_t> sizes(threads, 0);
+
+    for (uint64_t round{ 0 }; round < nodes; round += threads*round_nodes_gc) {
+        #pragma omp parallel for num_threads(threads)
+        for (uint32_t t = 0; t < threads; t++) {
+            const auto begin{ std::min(nodes, round + t*round_nodes_gc) };
+            const auto end{ std::min(nodes, begin + round_nodes_gc) };
+
+            char* pos{ buffers[t].data() };
+            for (auto i{ begin }; i < end; i++) pos = format_line(pos, first + static_cast<uint32_t>(i), ranks[i], exact);
+            sizes[t] = static_cast<uint64_t>(pos - buffers[t].data());
+        }
+
+        for (uint32_t t{ 0 }; t < threads; t++) out.write(buffers[t].data(), static_cast<std::streamsize>(sizes[t]));
+    }
+}
+
+auto utility::write_nodes(
+    std::ostream& out,
+    const std::span<const double> ranks,
+    const std::span<const uint32_t> nodes,
+    const bool exact) -> void {
+    std::string buffer(nodes.size()*line_bytes_gc, '\0');
+
+    char* pos{ buffer.data() };
+    for (size_t k{ 0 }; k < nodes.size(); k++) pos = format_line(pos, nodes[k], ranks[k], exact);
+    out.write(buffer.data(), pos - buffer.data());
+}
+
+auto utility::write_binary(
+    const std::string_view path,
+    const std::span<const double> ranks,
+    const bool single) -> void {
+    std::ofstream file(std::string(path), std::ios::binary);
+    if (!file) throw Error{ path, Error::ErrorCode::FILE_ERR };
+
+    if (!single) {
+        file.write(reinterpret_cast<const char*>(ranks.data()), static_cast<std::streamsize>(ranks.size_bytes()));
+    } else {
+        std::vector<float> chunk(convert_chunk_gc);
+        for (size_t first{ 0 }; first < ranks.size(); first += convert_chunk_gc) {
+            const auto count{ std::min<size_t>(convert_chunk_gc, ranks.size() - first) };
+            std::copy_n(ranks.begin() + first, count, chunk.begin());
+            file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(count*sizeof(float)));
+        }
+    }
+
+    if (!file.flush()) throw Error{ path, Error::ErrorCode::FILE_ERR };
+}
+
+auto utility::top_k(
+    const std::span<const double> ranks,
+    const uint32_t k,
+    const uint32_t threads) -> std::vector<uint32_t> {
+    const uint64_t nodes{ ranks.size() };
+    const auto keep{ static_cast<uint32_t>(std::min<uint64_t>(k, nodes)) };
+    // a strict order, so that the result does not depend on how the nodes were split
+    const auto higher{ [&](const uint32_t a, const uint32_t b) {
+        return ranks[a] != ranks[b] ? ranks[a] > ranks[b] : a < b;
+    } };
+
+    // with `higher` as the order, the front of every heap is the lowest node it kept
+    std::vector<std::vector<uint32_t>> heaps(threads);
+
+    #pragma omp parallel for num_threads(threads)
+    for (uint32_t t = 0; t < threads; t++) {
+        auto& heap{ heaps[t] };
+        heap.reserve(keep);
+
+        for (auto i{ nodes*t/threads }; i < nodes*(t + 1)/threads; i++) {
+            const auto node{ static_cast<uint32_t>(i) };
+            if (heap.size() < keep) {
+                heap.push_back(node);
+                std::push_heap(heap.begin(), heap.end(), higher);
+            } else if (keep != 0 && higher(node, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), higher);
+                heap.back() = node;
+                std::push_heap(heap.begin(), heap.end(), higher);
+            }
+        }
+    }
+
+    std::vector<uint32_t> best{};
+    best.reserve(static_cast<size_t>(keep)*threads);
+    for (const auto& heap : heaps) best.insert(best.end(), heap.begin(), heap.end());
+
+    std::partial_sort(best.begin(), best.begin() + keep, best.end(), higher);
+    best.resize(keep);
+    return best;
+}
+
+auto utility::write_output(
+    const std::span<const double> ranks,
+    const uint32_t width,
+    const std::vector<std::string>& headings,
+    const Options& options) -> void {
+    const auto path{ options.output_path };
+    if (!path.empty() && options.top_k == 0 && (path.ends_with(".f64") || path.ends_with(".f32"))) {
+        write_binary(path, ranks, path.ends_with(".f32"));
+        std::cout << "-> Ranks written to " << path << "\n";
+        return;
+    }
+
+    std::ofstream file{};
+    if (!path.empty()) {
+        file.open(std::string(path));
+        if (!file) throw Error{ path, Error::ErrorCode::FILE_ERR };
+    }
+    auto& out{ path.empty() ? std::cout : static_cast<std::ostream&>(file) };
+
+    std::vector<double> column{};
+    for (uint32_t k{ 0 }; k < width; k++) {
+        if (!headings.empty()) out << headings[k];
+
+        auto vector{ ranks };
+        if (width != 1) {
+            column.resize(ranks.size()/width);
+            for (size_t i{ 0 }; i < column.size(); i++) column[i] = ranks[i*width + k];
+            vector = column;
+        }
+
+        if (options.top_k != 0) {
+            const auto best{ top_k(vector, options.top_k, options.jobs) };
+            std::vector<double> best_ranks(best.size());
+            for (size_t k{ 0 }; k < best.size(); k++) best_ranks[k] = vector[best[k]];
+            write_nodes(out, best_ranks, best, !path.empty());
+        } else {
+            write_text(out, vector, !path.empty(), options.jobs, 0);
+        }
+    }
+
+    out.flush();
+    if (!out) throw Error{ path, Error::ErrorCode::FILE_ERR };
+    if (!path.empty()) std::cout << "-> Ranks written to " << path << "\n";
+}
@@ -0,0 +1,78 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _OUTPUT_HXX_
+#define _OUTPUT_HXX_
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+#include "types.hxx"
+
+// --- FUNCTION DECLARATIONS --- //
+
+namespace utility {
+  /// Write every rank as a `x[<node>] = <rank>` line, the first rank being that of node `first`.
+  /// The lines of `threads` chunks of nodes are formatted in parallel, a round of chunks at a
+  /// time, and written out in order. `exact` writes the shortest text that reads back as the
+  /// same double, and otherwise 6 significant digits, the way `std::ostream` does by default
+  auto write_text(
+    std::ostream& out,
+    const std::span<const double> ranks,
+    const bool exact,
+    const uint32_t threads,
+    const uint32_t first) -> void;
+
+  /// Write the rank `ranks[k]` of every node `nodes[k]`, in that order, the same way as `write_text()`
+  auto write_nodes(
+    std::ostream& out,
+    const std::span<const double> ranks,
+    const std::span<const uint32_t> nodes,
+    const bool exact) -> void;
+
+  /// Write the ranks to `path` as raw little endian doubles, or floats for `single`, with nothing else
+  auto write_binary(
+    const std::string_view path,
+    const std::span<const double> ranks,
+    const bool single) -> void;
+
+  /// The `k` nodes of the highest rank, highest first, the lower node first on ties. Every one of
+  /// `threads` threads keeps the best of its chunk in a heap, and the heaps are merged at the end
+  auto top_k(
+    const std::span<const double> ranks,
+    const uint32_t k,
+    const uint32_t threads) -> std::vector<uint32_t>;
+
+  /// Write `width` vectors of ranks, stored by node, where `--output` and `--top-k` say. The
+  /// standard output gets the digits of `std::ostream`, text files every bit of the ranks.
+  /// `headings` holds the line that goes before every vector, if any
+  auto write_output(
+    const std::span<const double> ranks,
+    const uint32_t width,
+    const std::vector<std::string>& headings,
+    const Options&) -> void;
+}
+
+#endif /* _OUTPUT_HXX_ */
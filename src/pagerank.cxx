@@ -19,165 +19,547 @@
 
 #include "pagerank.hxx"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iostream>
-#include <random>
-
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "distributed.hxx"
+#include "generate.hxx"
+#include "graph.hxx"
+#include "numa.hxx"
+#include "output.hxx"
+#include "profile.hxx"
+#include "ranks.hxx"
+#include "reorder.hxx"
+#include "segments.hxx"
+#include "solver.hxx"
 #include "types.hxx"
 
 using Error     = utility::Error;
 using ErrorCode = utility::Error::ErrorCode;
-using Matrix    = utility::Matrix;
+using Graph     = utility::Graph;
+
+// --- TYPES --- //
+
+/// The new order of the nodes of a run, if any, and what it cost and saved
+struct Reordering {
+  /// Node `order[p]` of the graph as given is node `p` of the solver. Empty if unchanged
+  std::vector<uint32_t> order{};
+  double                reorder_ms{ 0.0 };
+  /// The fastest sweep over the graph before and after
+  double                before_ms{ 0.0 };
+  double                after_ms{ 0.0 };
+};
+
+/// The timings of one benchmark configuration, over all of its tries
+struct BenchResult {
+  std::string_view solver{};
+  uint32_t         nodes{ 0 };
+  uint64_t         edges{ 0 };
+  uint32_t         jobs{ 1 };
+  uint32_t         tries{ 1 };
+  uint32_t         iterations{ 0 };
+  /// Median over all tries. The matrix is built while the graph is generated or
+  /// loaded, so this covers both
+  double           generate_ms{ 0.0 };
+  /// Min, median and 95th percentile of the wall time of every iteration of every try
+  std::array<double, 3> iteration_ms{};
+  /// At the fastest iteration time
+  double           gflops{ 0.0 };
+  double           gbps{ 0.0 };
+  uint64_t         bytes{ 0 };
+};
+
+using Clock = std::chrono::steady_clock;
+
+// --- CONSTANTS --- //
+
+/// How many sweeps to time before and after reordering
+constexpr uint32_t probe_sweeps_gc{ 3 };
+
+using exe::pagerank_parallel;
+using exe::pagerank_serial;
 
 // --- FUNCTION DECLARATIONS --- //
 
-static auto pagerank_serial(
-  Matrix& trans_matrix,
-  const utility::Options&) -> void;
-
-static auto pagerank_parallel(
-  Matrix& trans_matrix,
+/// Generate the graph of `--model`, straight into the matrix
+static auto generate_graph(const utility::Options&) -> Graph;
+/// Apply the links of `--delta` to `graph`, if any
+static auto apply_delta(
+  Graph& graph,
   const utility::Options&) -> void;
+/// Relabel the nodes of `graph` by `--reorder`, if any, and time a few sweeps before and after
+static auto reorder_graph(
+  Graph& graph,
+  const utility::Options&) -> Reordering;
+/// Bring the nodes of `batch` to the order of `reordering`
+static auto reorder_batch(
+  const exe::Batch& batch,
+  const Reordering& reordering,
+  const uint32_t threads) -> exe::Batch;
+/// Load the rank file at `path` (if any) for a graph with `nodes` nodes. Nodes
+/// the file does not know of start with an even share, and the ranks sum up to 1
+static auto load_start(
+  const std::string_view path,
+  const uint32_t nodes) -> utility::RankFile;
+
+/// How many source nodes every segment of a blocked sweep over `graph` spans, with `--block auto`
+/// sized so that half of the last level cache holds the scaled ranks of a segment. 0 means no blocking
+static auto block_nodes(
+  const Graph& graph,
+  const utility::Options&) -> uint32_t;
+
+/// Roughly how many bytes a single iteration has to move
+static auto bytes_per_iteration(const Graph&) -> uint64_t;
+static auto elapsed_ms(const Clock::time_point start) -> double;
+static auto percentile(
+  std::vector<double> samples,
+  const double fraction) -> double;
+static auto save_bench(
+  const std::vector<BenchResult>&,
+  const std::string_view path) -> void;
 
 // --- FUNCTION DEFINITIONS --- //
 
 auto exe::pagerank(const utility::Options& options) -> void {
   if (options.dump_fac >= 1 || options.dump_fac <= 0) throw Error{ "", ErrorCode::BAD_DUMPING_FAC_ERR };
+  // the transition matrix of a graph is always square
+  if (options.graph_path.empty() && (options.dims[0] != options.dims[1] || options.dims[0] == 0))
+    throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+
+  if (options.distributed) {
+    exe::pagerank_distributed(options);
+    return;
+  }
+
+  auto& profiler{ utility::Profiler::get() };
+  if (options.profile) profiler.enable(options.jobs, true);
+
+  // pinned before anything runs, so that even loading the graph happens on the right nodes
+  auto& numa{ utility::Numa::get() };
+  numa.enable(options.bind, options.jobs);
+
+  // both loading a file and generating a graph build the matrix in one go
+  profiler.begin_phase(options.graph_path.empty() ? "generation" : "load");
+  auto matrix{ options.graph_path.empty()
+    ? generate_graph(options)
+    : Graph::load(options.graph_path, options.jobs) };
+  profiler.end_phase();
+
+  apply_delta(matrix, options);
+  const auto reordering{ reorder_graph(matrix, options) };
+
+  if (numa.is_enabled()) {
+    const utility::Profiler::ScopedPhase phase("placement");
+    numa.place_graph(matrix, matrix.partition(options.jobs));
+    numa.record("offsets", matrix.offsets().data(), matrix.offsets().size_bytes());
+    numa.record("sources", matrix.sources().data(), matrix.sources().size_bytes());
+    numa.record("weights", matrix.weights().data(), matrix.weights().size_bytes());
+  }
+
+  auto run_options{ options };
+  run_options.block_nodes = block_nodes(matrix, options);
+
+  const auto batched{ !options.batch_path.empty() };
+  const auto reduced{ options.precision != utility::Precision::DOUBLE && options.method == utility::Method::POWER && !batched };
+  const auto blocked{ run_options.block_nodes != 0 && run_options.method == utility::Method::POWER };
 
   std::cout << R"(------ PAGERANK ------
--> Iterations to run the algorithm for: )" << options.iterations << R"(
--> Dimensions of the transition matrix: )" << options.dims[0] << "x" << options.dims[1] << R"(
+-> Iterations to run the algorithm for (at most): )" << options.iterations << R"(
+-> Tolerance: )" << options.tolerance << " (" << utility::norm_names_gc[static_cast<int>(options.norm)] << R"( norm)
+-> Dimensions of the transition matrix: )" << matrix.get_nodes() << "x" << matrix.get_nodes() << R"(
+-> Links in the graph: )" << matrix.get_edges() << R"(
 -> Dumping factor: )" << options.dump_fac << R"(
-)" << (options.do_serial
-    ? R"(-> Running the serial implementation)"
-    : R"(-> Threads to run the algorithm on )") << options.jobs << R"(
-----------------------
-)";
+-> Method: )" << utility::method_names_gc[batched ? 0 : static_cast<int>(options.method)] << "\n";
 
-  Matrix matrix(options.dims[0], options.dims[1]);
+  std::cout << "-> Precision: ";
+  if (reduced) std::cout << utility::precision_names_gc[static_cast<int>(options.precision)] << ", then double\n";
+  else std::cout << "double\n";
 
-  std::random_device random;
-  std::mt19937 generator(random());
-  std::uniform_int_distribution<uint64_t> dist(0, 1000);
+  std::cout << "-> Teleportation: ";
+  if (batched) std::cout << "batch " << options.batch_path << "\n";
+  else if (!options.personalize_path.empty()) std::cout << options.personalize_path << "\n";
+  else std::cout << "uniform\n";
 
-  for (uint32_t i{ 0 }; i < matrix.get_dimension<0>(); i++) {
-    for (uint32_t j{ 0 }; j < matrix.get_dimension<1>(); j++) {
-      matrix(i, j) = static_cast<double>(dist(generator));
+  std::cout << "-> Starting from: ";
+  if (!options.resume_path.empty()) std::cout << options.resume_path << " (resumed)\n";
+  else if (options.warm_path.empty()) std::cout << "teleportation\n";
+  else std::cout << options.warm_path << (options.push ? " (forward push)\n" : "\n");
+
+  if (!options.checkpoint_path.empty()) {
+    std::cout << "-> Checkpoints: " << options.checkpoint_path << " every " << options.checkpoint_every << " iterations\n";
+  }
+
+  std::cout << "-> Blocking: ";
+  if (blocked) {
+    const auto segments{ (static_cast<uint64_t>(matrix.get_nodes()) + run_options.block_nodes - 1)/run_options.block_nodes };
+    std::cout << segments << " segments of " << run_options.block_nodes << " nodes\n";
+  } else {
+    std::cout << "off\n";
+  }
+
+  if (!reordering.order.empty()) {
+    std::cout << "-> Reordering: " << utility::reorder_names_gc[static_cast<int>(options.reorder)] << " in " << reordering.reorder_ms
+              << " ms, sweep " << reordering.before_ms << " -> " << reordering.after_ms << " ms, ";
+    if (reordering.after_ms < reordering.before_ms) {
+      // every sweep saves the difference, so that many sweeps make up for the reordering itself
+      const auto payoff{ static_cast<uint64_t>(std::ceil(reordering.reorder_ms/(reordering.before_ms - reordering.after_ms))) };
+      std::cout << "pays off after " << payoff << " iterations\n";
+    } else {
+      std::cout << "never pays off\n";
     }
   }
 
-  // now we have to normalize the matrix
-  uint64_t total_in_column{ 0 };
-  for (uint32_t i{ 0 }; i < matrix.get_dimension<1>(); i++) {
-      for (uint32_t j{ 0 }; j < matrix.get_dimension<0>(); j++) {
-        total_in_column += static_cast<uint64_t>(matrix(j, i));
-      }
+  if (options.do_serial) std::cout << "-> Running the serial implementation\n";
+  else std::cout << "-> Threads to run the algorithm on: " << options.jobs << "\n";
+  std::cout << "----------------------\n";
+
+  if (!options.batch_path.empty()) {
+    const auto batch{ reorder_batch(exe::load_batch(options.batch_path, matrix.get_nodes()), reordering, options.jobs) };
+    auto solution{ exe::pagerank_batch(matrix, options, batch) };
+    if (!reordering.order.empty()) solution.ranks = utility::restore_rows(solution.ranks, reordering.order, batch.size, options.jobs);
+
+    profiler.begin_phase("output");
+    std::vector<std::string> headings(batch.size);
+    for (uint32_t k{ 0 }; k < batch.size; k++) {
+      std::ostringstream heading{};
+      heading << "-> Vector " << k << " (iterations run: " << solution.iterations[k]
+              << ", final residual: " << solution.residuals[k] << ")\n";
+      headings[k] = heading.str();
+    }
+    utility::write_output(solution.ranks, batch.size, headings, options);
+    profiler.end_phase();
 
-      for (uint32_t j{ 0 }; j < matrix.get_dimension<0>(); j++) {
-        matrix(j, i) /= static_cast<double>(total_in_column);
-      }
+    numa.report(std::cout);
+    profiler.report(std::cout);
+    if (!options.trace_path.empty()) profiler.save_trace(options.trace_path);
+    return;
+  }
 
-      total_in_column = 0;
+  auto teleport{ options.personalize_path.empty()
+    ? std::vector<double>{}
+    : exe::load_teleport(options.personalize_path, matrix.get_nodes()) };
+
+  auto start{ load_start(options.resume_path.empty() ? options.warm_path : options.resume_path, matrix.get_nodes()) };
+
+  // the files know of the nodes by their original labels
+  if (!reordering.order.empty()) {
+    if (!teleport.empty()) teleport = utility::permute_rows(teleport, reordering.order, 1, options.jobs);
+    if (!start.ranks.empty()) start.ranks = utility::permute_rows(start.ranks, reordering.order, 1, options.jobs);
+  }
+
+  // a resumed run goes on counting from where its checkpoint left off
+  const auto done{ options.resume_path.empty() ? 0 : start.iterations };
+  run_options.iterations = options.iterations > done ? options.iterations - done : 0;
+
+  auto& checkpoint{ utility::Checkpoint::get() };
+  if (!options.checkpoint_path.empty()) {
+    checkpoint.enable(options.checkpoint_path, options.checkpoint_every, done);
+    checkpoint.set_order(reordering.order);
   }
 
-  (options.do_serial
-   ? pagerank_serial
-   : pagerank_parallel)(matrix, options);
+  auto solution{ options.push && !start.ranks.empty()
+    ? exe::pagerank_push(matrix, run_options, teleport, start.ranks)
+    : (options.do_serial
+      ? pagerank_serial
+      : pagerank_parallel)(matrix, run_options, teleport, start.ranks) };
+  solution.iterations += done;
+  if (!reordering.order.empty()) solution.ranks = utility::restore_rows(solution.ranks, reordering.order, 1, options.jobs);
+
+  checkpoint.finish();
+
+  profiler.begin_phase("output");
+  utility::write_output(solution.ranks, 1, {}, options);
+  profiler.end_phase();
+
+  if (!options.ranks_path.empty()) {
+    const utility::Profiler::ScopedPhase phase("save ranks");
+    utility::save_ranks(options.ranks_path, solution.ranks, solution.iterations, solution.residual);
+  }
+
+  if (options.push) std::cout << "-> Forward pushes: " << solution.pushes << "\n";
+  if (checkpoint.get_skipped() != 0)
+    std::cout << "-> Checkpoints skipped while the last one was being written: " << checkpoint.get_skipped() << "\n";
+  if (solution.reduced != 0)
+    std::cout << "-> Iterations in " << utility::precision_names_gc[static_cast<int>(options.precision)] << ": " << solution.reduced << "\n";
+  std::cout << "-> Iterations run: " << solution.iterations
+            << "\n-> Final residual: " << solution.residual << "\n";
+
+  numa.report(std::cout);
+  profiler.report(std::cout);
+  if (!options.trace_path.empty()) profiler.save_trace(options.trace_path);
 }
 
-static auto pagerank_serial(
-  Matrix& trans_matrix,
+static auto apply_delta(
+  Graph& graph,
   const utility::Options& options) -> void {
-  auto& dump_fac{ options.dump_fac };
-  auto& iterations{ options.iterations };
+  if (options.delta_path.empty()) return;
+
+  const utility::Profiler::ScopedPhase phase("delta");
+  graph = graph.apply(Graph::load_delta(options.delta_path), options.jobs);
+}
+
+static auto reorder_graph(
+  Graph& graph,
+  const utility::Options& options) -> Reordering {
+  if (options.reorder == utility::Reorder::NONE) return {};
 
-  auto initial_vec{ Matrix(
-    trans_matrix.get_dimension<1>(),
-    1) };
+  const utility::Profiler::ScopedPhase phase("reorder");
+  Reordering reordering{};
+  reordering.before_ms = exe::time_sweeps(graph, options, probe_sweeps_gc);
 
-  auto added_vec{ Matrix(
-    trans_matrix.get_dimension<1>(),
-    1) };
+  const auto start{ Clock::now() };
+  reordering.order = utility::reorder(graph, options.reorder, options.jobs);
+  graph = graph.permute(reordering.order, options.jobs);
+  reordering.reorder_ms = elapsed_ms(start);
 
-  for (uint32_t i{0}; i < added_vec.get_dimension<0>(); i++) {
-    added_vec(i, 0) = 1.0 - dump_fac;
+  reordering.after_ms = exe::time_sweeps(graph, options, probe_sweeps_gc);
+  return reordering;
+}
+
+static auto reorder_batch(
+  const exe::Batch& batch,
+  const Reordering& reordering,
+  const uint32_t threads) -> exe::Batch {
+  if (reordering.order.empty()) return batch;
+
+  const auto& order{ reordering.order };
+  exe::Batch reordered{};
+  reordered.size = batch.size;
+  reordered.offsets.resize(order.size() + 1);
+  reordered.offsets[0] = 0;
+  for (size_t p{ 0 }; p < order.size(); p++) {
+    reordered.offsets[p + 1] = reordered.offsets[p] + (batch.offsets[order[p] + 1] - batch.offsets[order[p]]);
   }
 
-  for (uint32_t i{0}; i < initial_vec.get_dimension<0>(); i++) {
-    initial_vec(i, 0) = 0.0;
+  reordered.vectors.resize(batch.vectors.size());
+  reordered.weights.resize(batch.weights.size());
+  #pragma omp parallel for num_threads(threads)
+  for (size_t p = 0; p < order.size(); p++) {
+    const auto begin{ batch.offsets[order[p]] };
+    const auto end{ batch.offsets[order[p] + 1] };
+    std::copy(batch.vectors.begin() + begin, batch.vectors.begin() + end, reordered.vectors.begin() + reordered.offsets[p]);
+    std::copy(batch.weights.begin() + begin, batch.weights.begin() + end, reordered.weights.begin() + reordered.offsets[p]);
   }
 
-  try {
-    for (uint32_t i{0}; i <= iterations; i++) {
-      auto&& interm_matrix = trans_matrix*initial_vec;
+  return reordered;
+}
 
-      interm_matrix += added_vec;
-      initial_vec = interm_matrix;
-    }
+static auto load_start(
+  const std::string_view path,
+  const uint32_t nodes) -> utility::RankFile {
+  if (path.empty()) return {};
 
-    for (uint32_t i{0}; i < initial_vec.get_dimension<0>(); i++) {
-        std::cout << "x[" << i << "] = " << initial_vec(i, 0) << "\n";
-    }
-  } catch (Error err) {
-    switch (err.error) {
-      case ErrorCode::OUT_OF_BOUNDS_ERR:
-        std::cerr << "\x1b[31mERROR!! Went out of bounds! (FILE: " << err.erroneous << ")\x1b[0m\n";
-        break;
-      case ErrorCode::WRONG_DIMS_ERR:
-        std::cerr << "\x1b[31mERROR!! Matrices have wrong dimensions! (FILE: " << err.erroneous << ")\x1b[0m\n";
-        break;
-      default:
-        break;
-    }
+  auto start{ utility::load_ranks(path) };
+  if (start.ranks.size() > nodes) throw Error{ path, ErrorCode::BAD_FILE_ERR };
 
-    throw;
-  }
+  start.ranks.resize(nodes, 1.0/static_cast<double>(nodes));
+
+  double total{ 0.0 };
+  for (const auto rank : start.ranks) total += rank;
+  if (!(total > 0.0)) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+  for (auto& rank : start.ranks) rank /= total;
+
+  return start;
 }
 
-static auto pagerank_parallel(
-  Matrix& trans_matrix,
-  const utility::Options& options) -> void {
+static auto generate_graph(const utility::Options& options) -> Graph {
+  return Graph::from_source(
+    utility::generate_source(options.model, options.dims[0], options.degree, options.seed),
+    options.dims[0],
+    false,
+    options.jobs);
+}
 
-  auto initial_vec{ Matrix(
-    trans_matrix.get_dimension<1>(),
-    1) };
+auto exe::generate(const utility::Options& options) -> void {
+  if (options.dims[0] != options.dims[1] || options.dims[0] == 0) throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+  if (options.binary_path.empty()) throw Error{ "--binary", ErrorCode::NO_VALUE_ERR };
 
-  auto added_vec{ Matrix(
-    trans_matrix.get_dimension<1>(),
-    1) };
+  const auto graph{ generate_graph(options) };
+  graph.save(options.binary_path);
 
-  auto iterations{ options.iterations };
-  auto& dump_fac{ options.dump_fac };
+  std::cout << "Generated a " << utility::model_names_gc[static_cast<int>(options.model)] << " graph (" << graph.get_nodes()
+            << " nodes, " << graph.get_edges() << " links, seed " << options.seed << ") to " << options.binary_path << "\n";
+}
 
-  #pragma omp parallel num_threads(options.jobs)
-  {
-    #pragma omp for
-    for (uint32_t i = 0; i < initial_vec.get_dimension<0>(); i++) {
-      initial_vec(i, 0) = 0.0;
-      added_vec(i, 0) = 1.0 - dump_fac;
-    }
+auto exe::bench(const utility::Options& options) -> void {
+  if (options.dump_fac >= 1 || options.dump_fac <= 0) throw Error{ "", ErrorCode::BAD_DUMPING_FAC_ERR };
 
-    while (iterations > 0) {
-      double sum{ 0.0 };
+  const auto sweep_dims{ options.sweep_dims.empty()
+    ? std::vector<std::array<uint32_t, 2>>{ { options.dims[0], options.dims[1] } }
+    : options.sweep_dims };
+  const auto sweep_jobs{ options.sweep_jobs.empty()
+    ? std::vector<uint32_t>{ options.jobs }
+    : options.sweep_jobs };
 
-      #pragma omp for
-      for (uint32_t i = 0; i < trans_matrix.get_dimension<0>(); i++) {
-        for (uint32_t j{ 0 }; j < trans_matrix.get_dimension<1>(); j++) {
-          sum += trans_matrix(i, j)*initial_vec(j, 0);
-        }
-        #pragma omp critical
-        initial_vec(i, 0) = sum + added_vec(i, 0);
+  for (const auto& dims : sweep_dims) {
+    if (options.graph_path.empty() && (dims[0] != dims[1] || dims[0] == 0))
+      throw Error{ "", ErrorCode::WRONG_DIMS_ERR };
+  }
 
-        sum = 0.0;
-      }
+  // the serial solver does not depend on the thread count, so it is only timed once per size
+  struct Config {
+    std::array<uint32_t, 2> dims{};
+    uint32_t                jobs{ 1 };
+    bool                    do_serial{ true };
+  };
+  std::vector<Config> configs{};
+  for (const auto& dims : options.graph_path.empty() ? sweep_dims : std::vector{ sweep_dims[0] }) {
+    configs.push_back({ dims, sweep_jobs[0], true });
+    for (const auto jobs : sweep_jobs) configs.push_back({ dims, jobs, false });
+  }
 
-      #pragma omp barrier
+  std::vector<BenchResult> results{};
+  for (const auto& config : configs) {
+    auto run_options{ options };
+    run_options.dims[0] = config.dims[0];
+    run_options.dims[1] = config.dims[1];
+    run_options.jobs = config.jobs;
+    run_options.do_serial = config.do_serial;
+
+    BenchResult result{};
+    result.solver = config.do_serial ? "serial" : "parallel";
+    result.jobs = config.do_serial ? 1 : config.jobs;
+    result.tries = options.tries;
+
+    // the solvers open a profiler phase for every iteration, which is timed
+    // without any counters, so that every single iteration is a sample
+    auto& profiler{ utility::Profiler::get() };
+    profiler.enable(result.jobs, false);
+
+    std::vector<double> generate_ms{};
+    std::vector<double> iteration_ms{};
+    for (uint32_t t{ 0 }; t < options.tries; t++) {
+      // loading a file and generating a graph both build the matrix in one go, so it is all timed as generation
+      auto start{ Clock::now() };
+      const auto matrix{ options.graph_path.empty()
+        ? generate_graph(run_options)
+        : Graph::load(options.graph_path, run_options.jobs) };
+      generate_ms.push_back(elapsed_ms(start));
+
+      run_options.block_nodes = block_nodes(matrix, options);
+
+      const auto solution{ (config.do_serial
+       ? pagerank_serial
+       : pagerank_parallel)(matrix, run_options, {}, {}) };
+      for (const auto& phase : profiler.take_phases()) {
+        if (phase.name.starts_with("iteration "))
+          iteration_ms.push_back(std::chrono::duration<double, std::milli>(phase.end - phase.begin).count());
+      }
 
-      #pragma omp single
-      iterations--;
+      result.nodes = matrix.get_nodes();
+      result.edges = matrix.get_edges();
+      result.iterations = solution.iterations;
+      result.bytes = bytes_per_iteration(matrix);
     }
+
+    result.generate_ms = percentile(generate_ms, 0.5);
+    result.iteration_ms = {
+      percentile(iteration_ms, 0.0),
+      percentile(iteration_ms, 0.5),
+      percentile(iteration_ms, 0.95),
+    };
+    // every link costs a multiplication and an addition
+    result.gflops = 2.0*static_cast<double>(result.edges)/(result.iteration_ms[0]*1e6);
+    result.gbps = static_cast<double>(result.bytes)/(result.iteration_ms[0]*1e6);
+
+    std::cout << result.solver << " | " << result.nodes << " nodes, " << result.edges << " links | "
+              << result.jobs << " threads | iteration (min/median/p95): "
+              << result.iteration_ms[0] << "/" << result.iteration_ms[1] << "/" << result.iteration_ms[2] << " ms | "
+              << result.gflops << " GFLOP/s | " << result.gbps << " GB/s\n";
+
+    results.push_back(std::move(result));
   }
 
-  for (uint32_t i{0}; i < initial_vec.get_dimension<0>(); i++) {
-        std::cout << "x[" << i << "] = " << initial_vec(i, 0) << "\n";
+  if (!options.save_path.empty()) save_bench(results, options.save_path);
+}
+
+static auto block_nodes(
+  const Graph& graph,
+  const utility::Options& options) -> uint32_t {
+  if (!options.block_auto) return options.block_nodes;
+
+  const auto width{ utility::last_level_cache()/2/sizeof(double) };
+  // a single segment is just a sweep over whole rows, with extra steps
+  return width >= graph.get_nodes() ? 0 : static_cast<uint32_t>(width);
+}
+
+static auto bytes_per_iteration(const Graph& trans_matrix) -> uint64_t {
+  const uint64_t nodes{ trans_matrix.get_nodes() };
+  const uint64_t edges{ trans_matrix.get_edges() };
+
+  // the offsets and the out-degrees, reading the current ranks and writing the
+  // next ones (along with their scaled copies), and for every link its source,
+  // the scaled rank it gathers and, for weighted graphs, its weight
+  return nodes*(sizeof(uint64_t) + sizeof(uint32_t) + 3*sizeof(double))
+    + edges*(sizeof(uint32_t) + sizeof(double))
+    + (trans_matrix.is_weighted() ? edges*sizeof(double) : 0);
+}
+
+static auto elapsed_ms(const Clock::time_point start) -> double {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static auto percentile(
+  std::vector<double> samples,
+  const double fraction) -> double {
+  if (samples.empty()) return 0.0;
+
+  std::sort(samples.begin(), samples.end());
+  const auto index{ static_cast<size_t>(std::ceil(fraction*static_cast<double>(samples.size()))) };
+  return samples[std::min(samples.size() - 1, index == 0 ? 0 : index - 1)];
+}
+
+static auto save_bench(
+  const std::vector<BenchResult>& results,
+  const std::string_view path) -> void {
+  std::ofstream file{ std::string(path) };
+  if (!file) throw Error{ path, ErrorCode::FILE_ERR };
+
+  const auto as_json{ path.ends_with(".json") };
+  file << (as_json
+    ? "[\n"
+    : "solver,nodes,edges,jobs,tries,iterations,generate_ms,iteration_min_ms,iteration_median_ms,iteration_p95_ms,gflops,gbps\n");
+
+  for (size_t r{ 0 }; r < results.size(); r++) {
+    const auto& result{ results[r] };
+    if (as_json) {
+      file << "  {\"solver\": \"" << result.solver << "\", \"nodes\": " << result.nodes << ", \"edges\": " << result.edges
+           << ", \"jobs\": " << result.jobs << ", \"tries\": " << result.tries
+           << ", \"iterations\": " << result.iterations
+           << ", \"generate_ms\": " << result.generate_ms
+           << ", \"iteration_min_ms\": " << result.iteration_ms[0]
+           << ", \"iteration_median_ms\": " << result.iteration_ms[1]
+           << ", \"iteration_p95_ms\": " << result.iteration_ms[2]
+           << ", \"gflops\": " << result.gflops << ", \"gbps\": " << result.gbps
+           << (r + 1 < results.size() ? "},\n" : "}\n");
+    } else {
+      file << result.solver << "," << result.nodes << "," << result.edges
+           << "," << result.jobs << "," << result.tries << "," << result.iterations << "," << result.generate_ms
+           << "," << result.iteration_ms[0] << "," << result.iteration_ms[1] << "," << result.iteration_ms[2]
+           << "," << result.gflops << "," << result.gbps << "\n";
+    }
   }
+
+  if (as_json) file << "]\n";
+  if (!file) throw Error{ path, ErrorCode::FILE_ERR };
+}
+
+auto exe::convert(const utility::Options& options) -> void {
+  if (options.graph_path.empty()) throw Error{ "--graph", ErrorCode::NO_VALUE_ERR };
+  if (options.binary_path.empty()) throw Error{ "--binary", ErrorCode::NO_VALUE_ERR };
+
+  auto graph{ Graph::load(options.graph_path, options.jobs) };
+  apply_delta(graph, options);
+  graph.save(options.binary_path);
+
+  std::cout << "Converted " << options.graph_path << " (" << graph.get_nodes() << " nodes, "
+            << graph.get_edges() << " links) to " << options.binary_path << "\n";
 }
@@ -23,7 +23,15 @@
 #include "types.hxx"
 
 namespace exe {
+
   auto pagerank(const utility::Options&) -> void;
+  /// Benchmark the serial and the parallel solver over every `sweep_dims`
+  /// and `sweep_jobs`, repeating every configuration `tries` times
+  auto bench(const utility::Options&) -> void;
+  /// Generate a random graph (see `utility::generate_source`) to the binary graph format at `binary_path`
+  auto generate(const utility::Options&) -> void;
+  /// Convert the graph at `graph_path` to the binary graph format at `binary_path`
+  auto convert(const utility::Options&) -> void;
 }
 
 #endif /* _PAGERANK_HXX_ */
@@ -0,0 +1,155 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "pool.hxx"
+
+#include <algorithm>
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// How many times an idle thread checks for a new job before it goes to sleep. Jobs that
+/// follow each other closely, like the sweeps of a solver, then find the threads awake
+constexpr uint32_t spins_gc{ 1 << 10 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+static inline auto pack(
+    const uint32_t begin,
+    const uint32_t end) -> uint64_t;
+static inline auto begin_of(const uint64_t range) -> uint32_t;
+static inline auto end_of(const uint64_t range) -> uint32_t;
+
+// --- FUNCTION DEFINITIONS --- //
+
+static inline auto pack(
+    const uint32_t begin,
+    const uint32_t end) -> uint64_t {
+    return static_cast<uint64_t>(begin) << 32 | end;
+}
+
+static inline auto begin_of(const uint64_t range) -> uint32_t {
+    return static_cast<uint32_t>(range >> 32);
+}
+
+static inline auto end_of(const uint64_t range) -> uint32_t {
+    return static_cast<uint32_t>(range);
+}
+
+Pool::Pool(const uint32_t threads)
+    : threads{ std::max(threads, 1u) },
+      queues{ std::make_unique<Queue[]>(std::max(threads, 1u)) } {
+    this->workers.reserve(this->threads - 1);
+    for (uint32_t w{ 1 }; w < this->threads; w++) {
+        this->workers.emplace_back([this, w] { this->serve(w); });
+    }
+}
+
+Pool::~Pool() {
+    this->stopping.store(true, std::memory_order_release);
+    this->epoch.fetch_add(1, std::memory_order_release);
+    this->epoch.notify_all();
+    for (auto& worker : this->workers) worker.join();
+}
+
+auto Pool::run_tasks(
+    const uint32_t tasks,
+    const Body body,
+    const void* context) -> void {
+    const std::lock_guard lock{ this->running };
+
+    this->body = body;
+    this->context = context;
+    for (uint32_t w{ 0 }; w < this->threads; w++) {
+        const auto begin{ static_cast<uint32_t>(static_cast<uint64_t>(tasks)*w/this->threads) };
+        const auto end{ static_cast<uint32_t>(static_cast<uint64_t>(tasks)*(w + 1)/this->threads) };
+        this->queues[w].range.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    if (this->threads > 1) {
+        this->working.store(this->threads - 1, std::memory_order_relaxed);
+        this->epoch.fetch_add(1, std::memory_order_release);
+        this->epoch.notify_all();
+    }
+
+    this->work(0);
+
+    // the job lives on the stack of the caller, so every thread has to be done with it
+    for (auto left{ this->working.load(std::memory_order_acquire) }; left != 0;
+         left = this->working.load(std::memory_order_acquire)) {
+        this->working.wait(left, std::memory_order_acquire);
+    }
+}
+
+auto Pool::work(const uint32_t worker) -> void {
+    auto& own{ this->queues[worker].range };
+
+    while (true) {
+        auto range{ own.load(std::memory_order_acquire) };
+        while (begin_of(range) < end_of(range)) {
+            const auto task{ begin_of(range) };
+            if (own.compare_exchange_weak(range, pack(task + 1, end_of(range)), std::memory_order_acq_rel)) {
+                this->body(this->context, task, worker);
+                range = own.load(std::memory_order_acquire);
+            }
+        }
+
+        // out of tasks, so take the back half of the first range that still has some
+        bool stolen{ false };
+        for (uint32_t k{ 1 }; k < this->threads && !stolen; k++) {
+            auto& victim{ this->queues[(worker + k) % this->threads].range };
+            auto theirs{ victim.load(std::memory_order_acquire) };
+            while (begin_of(theirs) < end_of(theirs)) {
+                const auto take{ std::max((end_of(theirs) - begin_of(theirs))/2, 1u) };
+                const auto split{ end_of(theirs) - take };
+                if (victim.compare_exchange_weak(theirs, pack(begin_of(theirs), split), std::memory_order_acq_rel)) {
+                    own.store(pack(split, split + take), std::memory_order_release);
+                    stolen = true;
+                    break;
+                }
+            }
+        }
+
+        if (!stolen) return;
+    }
+}
+
+auto Pool::serve(const uint32_t worker) -> void {
+    uint64_t seen{ 0 };
+
+    while (true) {
+        auto now{ this->epoch.load(std::memory_order_acquire) };
+        for (uint32_t spin{ 0 }; spin < spins_gc && now == seen; spin++) {
+            std::this_thread::yield();
+            now = this->epoch.load(std::memory_order_acquire);
+        }
+        while (now == seen) {
+            this->epoch.wait(seen, std::memory_order_acquire);
+            now = this->epoch.load(std::memory_order_acquire);
+        }
+        seen = now;
+
+        if (this->stopping.load(std::memory_order_acquire)) return;
+
+        this->work(worker);
+        if (this->working.fetch_sub(1, std::memory_order_acq_rel) == 1) this->working.notify_one();
+    }
+}
@@ -0,0 +1,108 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _POOL_HXX_
+#define _POOL_HXX_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+// --- TYPES --- //
+
+namespace utility {
+  /// A team of threads that lives as long as the pool does, so that running a job costs
+  /// waking them up and nothing else.
+  ///
+  /// The tasks of a job are dealt out to the threads in even ranges. Every thread takes
+  /// tasks off the front of its own range, and once that runs dry, steals the back half
+  /// of the range of another one, until no task is left anywhere. The calling thread is
+  /// thread 0 of the team and works along.
+  ///
+  /// A pool runs a single job at a time, and jobs from different threads take turns
+  class Pool {
+    public:
+      // --- TYPES --- //
+      using Body = void (*)(const void* context, const uint32_t task, const uint32_t worker);
+
+    private:
+      /// The tasks a thread has left, `[begin, end)` packed as `begin << 32 | end`, so
+      /// that both the owner and the thieves take their share with a single CAS
+      struct alignas(64) Queue {
+        std::atomic<uint64_t> range{ 0 };
+      };
+
+      // --- FIELDS --- //
+      uint32_t                 threads{ 1 };
+      std::unique_ptr<Queue[]> queues{};
+      std::vector<std::thread> workers{};
+      std::mutex               running{};
+      // the job, written before `epoch` moves on
+      Body                     body{ nullptr };
+      const void*              context{ nullptr };
+      std::atomic<uint64_t>    epoch{ 0 };
+      /// How many threads other than the caller are still on the job
+      std::atomic<uint32_t>    working{ 0 };
+      std::atomic<bool>        stopping{ false };
+
+      /// Run tasks on thread `worker` until there are none left to take
+      auto work(const uint32_t worker) -> void;
+      /// The loop of every thread but the caller
+      auto serve(const uint32_t worker) -> void;
+      auto run_tasks(
+        const uint32_t tasks,
+        const Body,
+        const void* context) -> void;
+
+    public:
+      /// Start a pool of `threads` threads, counting the one that runs the jobs
+      explicit Pool(const uint32_t threads);
+      ~Pool();
+
+      Pool(const Pool&) = delete;
+      auto operator=(const Pool&) -> Pool& = delete;
+
+      inline auto get_threads() const -> uint32_t {
+        return this->threads;
+      }
+
+      /// Call `body(task, worker)` for every task in `[0, tasks)` and return once all of them
+      /// are done. `worker` is the thread a call runs on, below `get_threads()`. `body` must
+      /// not throw, nor run jobs on the same pool
+      template <typename Function>
+      auto run(
+        const uint32_t tasks,
+        const Function& body) -> void {
+        this->run_tasks(
+          tasks,
+          [](const void* context, const uint32_t task, const uint32_t worker) {
+            (*static_cast<const Function*>(context))(task, worker);
+          },
+          &body);
+      }
+  };
+}
+
+#endif /* _POOL_HXX_ */
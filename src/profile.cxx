@@ -0,0 +1,251 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "profile.hxx"
+
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+
+#include <omp.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "types.hxx"
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+constexpr const char* counter_names_gc[]{ "cycles", "instructions", "llc_misses", "dtlb_misses" };
+
+// --- FUNCTION DEFINITIONS --- //
+
+#ifdef __linux__
+/// Open counter `counter` for the calling thread, on any CPU. Returns -1 if
+/// the kernel does not let us (no PMU, or a strict `perf_event_paranoid`)
+static auto open_counter(const Profiler::Counter counter) -> int {
+    perf_event_attr attr{};
+    attr.size = sizeof(perf_event_attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    switch (counter) {
+        case Profiler::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Profiler::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case Profiler::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL
+                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB
+                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+Profiler::~Profiler() {
+#ifdef __linux__
+    for (const auto& fds : this->counter_fds) {
+        for (const auto fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+#endif
+}
+
+auto Profiler::get() -> Profiler& {
+    static Profiler profiler{};
+    return profiler;
+}
+
+auto Profiler::enable(
+    const uint32_t threads,
+    const bool counters) -> void {
+    this->enabled = true;
+    this->start = Clock::now();
+    this->lanes.resize(threads);
+    this->available.fill(counters);
+    if (!counters) return;
+
+    this->counter_fds.resize(threads);
+
+    // counters follow the thread that opened them, so every thread of the
+    // team opens its own. OpenMP keeps reusing these threads for teams of
+    // the same size, which is what the solvers use
+    #pragma omp parallel num_threads(threads)
+    {
+        auto& fds{ this->counter_fds[omp_get_thread_num()] };
+        for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+#ifdef __linux__
+            fds[c] = open_counter(static_cast<Counter>(c));
+#else
+            fds[c] = -1;
+#endif
+        }
+    }
+
+    for (const auto& fds : this->counter_fds) {
+        for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+            if (fds[c] < 0) this->available[c] = false;
+        }
+    }
+}
+
+auto Profiler::read_counters() const -> Counters {
+    Counters counters{};
+#ifdef __linux__
+    for (const auto& fds : this->counter_fds) {
+        for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+            uint64_t value{ 0 };
+            if (fds[c] >= 0 && read(fds[c], &value, sizeof(value)) == sizeof(value)) counters[c] += value;
+        }
+    }
+#endif
+    return counters;
+}
+
+auto Profiler::begin_phase(std::string name) -> void {
+    if (!this->enabled) return;
+
+    this->open_counters = this->read_counters();
+    this->phases.push_back({ std::move(name), Clock::now(), {}, {} });
+}
+
+auto Profiler::end_phase() -> void {
+    if (!this->enabled || this->phases.empty()) return;
+
+    auto& phase{ this->phases.back() };
+    phase.end = Clock::now();
+
+    const auto counters{ this->read_counters() };
+    for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+        phase.counters[c] = counters[c] - this->open_counters[c];
+    }
+}
+
+auto Profiler::take_phases() -> std::vector<Phase> {
+    for (auto& lane : this->lanes) lane.clear();
+    return std::exchange(this->phases, {});
+}
+
+auto Profiler::report(std::ostream& out) const -> void {
+    if (!this->enabled) return;
+
+    out << "------ PROFILE ------\n"
+        << std::left << std::setw(16) << "phase" << std::right << std::setw(12) << "ms";
+    for (const auto* name : counter_names_gc) out << std::setw(16) << name;
+    out << std::setw(8) << "ipc" << "\n";
+
+    for (const auto& phase : this->phases) {
+        out << std::left << std::setw(16) << phase.name << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::milli>(phase.end - phase.begin).count();
+
+        for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+            if (this->available[c]) out << std::setw(16) << phase.counters[c];
+            else out << std::setw(16) << "n/a";
+        }
+
+        if (this->available[CYCLES] && this->available[INSTRUCTIONS] && phase.counters[CYCLES] != 0)
+            out << std::setw(8) << std::setprecision(2)
+                << static_cast<double>(phase.counters[INSTRUCTIONS])/static_cast<double>(phase.counters[CYCLES]);
+        else
+            out << std::setw(8) << "n/a";
+        out << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6) << "---------------------\n";
+}
+
+auto Profiler::save_trace(const std::string_view path) const -> void {
+    std::ofstream file{ std::string(path) };
+    if (!file) throw Error{ path, Error::ErrorCode::FILE_ERR };
+
+    const auto micros{ [&](const Clock::time_point point) {
+        return std::chrono::duration<double, std::micro>(point - this->start).count();
+    } };
+
+    file << "{\"traceEvents\": [\n";
+    for (size_t lane{ 0 }; lane < this->lanes.size(); lane++) {
+        file << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << lane + 1
+             << ", \"args\": {\"name\": \"thread " << lane << "\"}},\n";
+    }
+    file << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"phases\"}}";
+
+    for (const auto& phase : this->phases) {
+        file << ",\n  {\"name\": \"" << phase.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": "
+             << micros(phase.begin) << ", \"dur\": " << micros(phase.end) - micros(phase.begin) << ", \"args\": {";
+        bool first{ true };
+        for (int c{ 0 }; c < COUNTER_COUNT; c++) {
+            if (!this->available[c]) continue;
+
+            file << (first ? "" : ", ") << "\"" << counter_names_gc[c] << "\": " << phase.counters[c];
+            first = false;
+        }
+        file << "}}";
+    }
+
+    for (size_t lane{ 0 }; lane < this->lanes.size(); lane++) {
+        for (const auto& span : this->lanes[lane]) {
+            file << ",\n  {\"name\": \"" << span.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << lane + 1
+                 << ", \"ts\": " << micros(span.begin) << ", \"dur\": " << micros(span.end) - micros(span.begin) << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file) throw Error{ path, Error::ErrorCode::FILE_ERR };
+}
+
+Profiler::ScopedSpan::ScopedSpan(const char* name)
+    : name(name) {
+    if (Profiler::get().enabled) this->begin = Clock::now();
+}
+
+Profiler::ScopedSpan::~ScopedSpan() {
+    auto& profiler{ Profiler::get() };
+    if (!profiler.enabled) return;
+
+    const auto lane{ static_cast<size_t>(omp_get_thread_num()) };
+    if (lane < profiler.lanes.size()) profiler.lanes[lane].push_back({ this->name, this->begin, Clock::now() });
+}
+
+Profiler::ScopedPhase::ScopedPhase(std::string name) {
+    Profiler::get().begin_phase(std::move(name));
+}
+
+Profiler::ScopedPhase::~ScopedPhase() {
+    Profiler::get().end_phase();
+}
@@ -0,0 +1,138 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PROFILE_HXX_
+#define _PROFILE_HXX_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+// --- TYPES --- //
+
+namespace utility {
+  /// Opt-in instrumentation of the phases of a run.
+  ///
+  /// *Phases* (generation or loading, every iteration, output, ...) are opened and
+  /// closed by the main thread, outside of any parallel work, and get both their
+  /// wall-clock time and, on Linux, the hardware counters of all threads.
+  /// *Spans* are timed by every thread on its own lane, for the trace.
+  ///
+  /// While disabled, every call returns right away.
+  class Profiler {
+    public:
+      // --- TYPES --- //
+      enum Counter : int {
+        CYCLES = 0,
+        INSTRUCTIONS = 1,
+        LLC_MISSES = 2,
+        DTLB_MISSES = 3,
+        COUNTER_COUNT = 4,
+      };
+
+      using Clock    = std::chrono::steady_clock;
+      using Counters = std::array<uint64_t, COUNTER_COUNT>;
+
+      struct Phase {
+        std::string       name{};
+        Clock::time_point begin{};
+        Clock::time_point end{};
+        Counters          counters{};
+      };
+
+      struct Span {
+        const char*       name{ "" };
+        Clock::time_point begin{};
+        Clock::time_point end{};
+      };
+
+      /// Times the enclosing scope as a span on the lane of the calling thread
+      class ScopedSpan {
+        private:
+          const char*       name{ "" };
+          Clock::time_point begin{};
+
+        public:
+          ScopedSpan(const char* name);
+          ~ScopedSpan();
+      };
+
+      /// Times the enclosing scope as a phase. Only for the main thread
+      class ScopedPhase {
+        public:
+          ScopedPhase(std::string name);
+          ~ScopedPhase();
+      };
+
+    private:
+      // --- FIELDS --- //
+      bool                           enabled{ false };
+      /// Whether every thread managed to open each counter
+      std::array<bool, COUNTER_COUNT> available{};
+      Clock::time_point              start{};
+      std::vector<Phase>             phases{};
+      std::vector<std::vector<Span>> lanes{};
+      /// One group of counter file descriptors per thread
+      std::vector<std::array<int, COUNTER_COUNT>> counter_fds{};
+      /// The counters at the start of the phase that is currently open
+      Counters                       open_counters{};
+
+      Profiler() = default;
+
+      auto read_counters() const -> Counters;
+
+    public:
+      ~Profiler();
+
+      static auto get() -> Profiler&;
+
+      /// Start profiling runs on up to `threads` threads. With `counters`, they are opened
+      /// on every thread of the OpenMP team, so this has to be called before the parallel
+      /// work starts. Without them, phases and spans only get their wall-clock time
+      auto enable(
+        const uint32_t threads,
+        const bool counters) -> void;
+
+      inline auto is_enabled() const -> bool {
+        return this->enabled;
+      }
+
+      auto begin_phase(std::string name) -> void;
+      auto end_phase() -> void;
+
+      /// Hand over the phases so far and drop the spans, so that the next run starts afresh
+      auto take_phases() -> std::vector<Phase>;
+
+      /// Print every phase, along with its counters
+      auto report(std::ostream&) const -> void;
+
+      /// Write a Chrome trace-event file, with the phases and one lane per thread
+      auto save_trace(const std::string_view path) const -> void;
+
+      friend class ScopedSpan;
+  };
+}
+
+#endif /* _PROFILE_HXX_ */
@@ -0,0 +1,173 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ranks.hxx"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "graph.hxx"
+#include "reorder.hxx"
+#include "types.hxx"
+
+using namespace utility;
+
+auto utility::save_ranks(
+    const std::string_view path,
+    const std::span<const double> ranks,
+    const uint32_t iterations,
+    const double residual) -> void {
+    RankHeader header{};
+    header.iterations = iterations;
+    header.nodes = ranks.size();
+    header.residual = residual;
+
+    const std::string path_str(path);
+    const auto temp_str{ path_str + ".tmp" };
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(temp_str.c_str(), "wb"), &std::fclose);
+        if (file == nullptr) throw Error{ path, Error::ErrorCode::FILE_ERR };
+
+        if (std::fwrite(&header, sizeof(RankHeader), 1, file.get()) != 1
+            || std::fwrite(ranks.data(), sizeof(double), ranks.size(), file.get()) != ranks.size()
+            || std::fflush(file.get()) != 0)
+            throw Error{ path, Error::ErrorCode::FILE_ERR };
+    }
+
+    if (std::rename(temp_str.c_str(), path_str.c_str()) != 0) throw Error{ path, Error::ErrorCode::FILE_ERR };
+}
+
+auto utility::load_ranks(const std::string_view path) -> RankFile {
+    const MappedFile file(path);
+
+    RankHeader header{};
+    if (file.get_size() < sizeof(RankHeader)) throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+    std::memcpy(&header, file.data(), sizeof(RankHeader));
+
+    const RankHeader magic_header{};
+    if (!std::equal(magic_header.magic, magic_header.magic + 8, header.magic)
+        || header.version != magic_header.version
+        || header.nodes != (file.get_size() - sizeof(RankHeader))/sizeof(double))
+        throw Error{ path, Error::ErrorCode::BAD_FILE_ERR };
+
+    RankFile ranks{
+        .ranks = std::vector<double>(header.nodes),
+        .iterations = header.iterations,
+        .residual = header.residual,
+    };
+    std::memcpy(ranks.ranks.data(), file.data() + sizeof(RankHeader), header.nodes*sizeof(double));
+
+    return ranks;
+}
+
+auto Checkpoint::get() -> Checkpoint& {
+    static Checkpoint checkpoint{};
+    return checkpoint;
+}
+
+Checkpoint::~Checkpoint() {
+    {
+        const std::lock_guard guard(this->lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    if (this->worker.joinable()) this->worker.join();
+}
+
+auto Checkpoint::enable(
+    const std::string_view path,
+    const uint32_t every,
+    const uint32_t offset) -> void {
+    this->path = path;
+    this->every = every;
+    this->offset = offset;
+    if (!this->worker.joinable()) this->worker = std::thread(&Checkpoint::run, this);
+}
+
+auto Checkpoint::set_order(std::vector<uint32_t> order) -> void {
+    this->order = std::move(order);
+}
+
+auto Checkpoint::acquire(
+    const uint32_t iteration,
+    const uint32_t nodes) -> double* {
+    if (this->every == 0 || iteration == 0 || iteration % this->every != 0) return nullptr;
+
+    const std::lock_guard guard(this->lock);
+    if (this->busy) {
+        this->skipped++;
+        return nullptr;
+    }
+
+    this->busy = true;
+    this->buffer.resize(nodes);
+    return this->buffer.data();
+}
+
+auto Checkpoint::submit(
+    const uint32_t iteration,
+    const double residual) -> void {
+    {
+        const std::lock_guard guard(this->lock);
+        this->iterations = this->offset + iteration;
+        this->residual = residual;
+        this->pending = true;
+    }
+    this->wake.notify_all();
+}
+
+auto Checkpoint::finish() -> void {
+    std::unique_lock guard(this->lock);
+    this->wake.wait(guard, [this] { return !this->busy; });
+
+    if (this->error.has_value()) {
+        const auto error{ *this->error };
+        this->error.reset();
+        throw error;
+    }
+}
+
+auto Checkpoint::run() -> void {
+    std::unique_lock guard(this->lock);
+    while (true) {
+        this->wake.wait(guard, [this] { return this->pending || this->stopping; });
+        if (!this->pending) return;
+
+        // nobody else touches the buffer until it is released, so the
+        // file can be written without holding the lock
+        guard.unlock();
+        std::optional<Error> error{};
+        try {
+            if (this->order.empty()) save_ranks(this->path, this->buffer, this->iterations, this->residual);
+            else save_ranks(this->path, restore_rows(this->buffer, this->order, 1, 1), this->iterations, this->residual);
+        } catch (const Error& err) {
+            error = err;
+        }
+        guard.lock();
+
+        if (error.has_value() && !this->error.has_value()) this->error = error;
+        this->pending = false;
+        this->busy = false;
+        this->wake.notify_all();
+    }
+}
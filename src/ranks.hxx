@@ -0,0 +1,150 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RANKS_HXX_
+#define _RANKS_HXX_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include "types.hxx"
+
+// --- TYPES --- //
+
+namespace utility {
+  /// Header of the binary rank file format, which is followed by the rank
+  /// of every node as a little endian double
+  struct RankHeader {
+    char     magic[8]{ 'P', 'R', 'R', 'A', 'N', 'K', 'S', '\0' };
+    uint32_t version{ 1 };
+    /// How many iterations produced the ranks
+    uint32_t iterations{ 0 };
+    uint64_t nodes{ 0 };
+    /// The residual of the last of those iterations
+    double   residual{ 0.0 };
+    char     reserved[32]{};
+  };
+
+  static_assert(sizeof(RankHeader) == 64);
+
+  /// The contents of a rank file
+  struct RankFile {
+    std::vector<double> ranks{};
+    uint32_t            iterations{ 0 };
+    double              residual{ 0.0 };
+  };
+
+  /// Periodic rank files of a running solver, written by a thread of their own.
+  ///
+  /// At every checkpoint the solver copies its ranks into the buffer of `acquire()`
+  /// and hands it back with `submit()`, and goes on while the file gets written. If
+  /// the last file is still being written by the next checkpoint, that one is skipped
+  /// rather than waited for.
+  ///
+  /// While disabled, `acquire()` always returns null
+  class Checkpoint {
+    private:
+      // --- FIELDS --- //
+      std::string                 path{};
+      uint32_t                    every{ 0 };
+      /// The iterations already behind the ranks the solver started from
+      uint32_t                    offset{ 0 };
+      /// The order of the nodes the solver works with, to undo before writing. Empty if unchanged
+      std::vector<uint32_t>       order{};
+      //
+      std::thread                 worker{};
+      std::mutex                  lock{};
+      std::condition_variable     wake{};
+      /// The ranks to write, which the solver only touches between `acquire()` and `submit()`
+      std::vector<double>         buffer{};
+      uint32_t                    iterations{ 0 };
+      double                      residual{ 0.0 };
+      /// Whether `buffer` is handed out or waits to be written
+      bool                        busy{ false };
+      bool                        pending{ false };
+      bool                        stopping{ false };
+      uint32_t                    skipped{ 0 };
+      /// The first error of the writer, which `finish()` throws
+      std::optional<Error>        error{};
+
+      Checkpoint() = default;
+
+      auto run() -> void;
+
+    public:
+      ~Checkpoint();
+
+      static auto get() -> Checkpoint&;
+
+      /// Write the ranks to `path` every `every` iterations. The solver counts
+      /// its iterations from 0, and `offset` is added to them in the file
+      auto enable(
+        const std::string_view path,
+        const uint32_t every,
+        const uint32_t offset) -> void;
+
+      inline auto is_enabled() const -> bool {
+        return this->every != 0;
+      }
+
+      /// The solver works with the nodes relabeled, node `order[p]` being node `p`
+      auto set_order(std::vector<uint32_t> order) -> void;
+
+      /// Where to copy the `nodes` ranks after `iteration` iterations to, or null
+      /// if no checkpoint is due or the last one is still being written
+      auto acquire(
+        const uint32_t iteration,
+        const uint32_t nodes) -> double*;
+
+      /// Hand the buffer of `acquire()` over to the writer
+      auto submit(
+        const uint32_t iteration,
+        const double residual) -> void;
+
+      /// Wait for the last file to be written. Throws the first error of the writer
+      auto finish() -> void;
+
+      inline auto get_skipped() const -> uint32_t {
+        return this->skipped;
+      }
+  };
+
+  // --- FUNCTION DECLARATIONS --- //
+
+  /// Write a rank file. It is written next to `path` first and then moved
+  /// over it, so `path` always holds either the old or the new ranks
+  auto save_ranks(
+    const std::string_view path,
+    const std::span<const double> ranks,
+    const uint32_t iterations,
+    const double residual) -> void;
+
+  auto load_ranks(const std::string_view path) -> RankFile;
+}
+
+#endif /* _RANKS_HXX_ */
@@ -0,0 +1,371 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "reorder.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include <omp.h>
+
+using namespace utility;
+
+// --- TYPES --- //
+
+/// The links of a graph in both directions, as a CSR where row `i` holds
+/// every node that links to `i` or that `i` links to
+struct Adjacency {
+    std::vector<uint64_t> offsets{};
+    std::vector<uint32_t> neighbors{};
+};
+
+// --- CONSTANTS --- //
+
+/// Below this many nodes, a level of the Cuthill-McKee search is not worth a parallel region
+constexpr uint32_t parallel_level_gc{ 1024 };
+/// The most rounds of label propagation that look for the communities of `Reorder::RABBIT`
+constexpr uint32_t label_rounds_gc{ 8 };
+/// Marks a node no level has claimed yet
+constexpr uint32_t unclaimed_gc{ std::numeric_limits<uint32_t>::max() };
+
+// --- FUNCTION DECLARATIONS --- //
+
+/// Sort `nodes` by `less`, a strict total order, on `threads` threads. The chunks of every
+/// thread are sorted on their own and then merged pairwise, in rounds
+template <typename Less>
+static auto sort_nodes(
+    std::vector<uint32_t>& nodes,
+    const Less& less,
+    const uint32_t threads) -> void;
+
+static auto make_adjacency(
+    const Graph& graph,
+    const uint32_t threads) -> Adjacency;
+
+/// By decreasing out-degree, so that the hubs every sweep gathers from share their cache lines
+static auto degree_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t>;
+
+/// Reverse Cuthill-McKee: a breadth-first search from a node of the lowest degree, where the
+/// nodes every level finds are ordered by the position of their parent and their own degree.
+/// The levels are searched in parallel, and every node goes to the first parent that finds it,
+/// as in the serial search
+static auto rcm_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t>;
+
+/// Community by community, with the communities found by label propagation, and the nodes of
+/// every community by decreasing out-degree
+static auto community_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t>;
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto utility::reorder(
+    const Graph& graph,
+    const Reorder how,
+    const uint32_t threads) -> std::vector<uint32_t> {
+    switch (how) {
+        case Reorder::DEGREE:
+            return degree_order(graph, threads);
+        case Reorder::RCM:
+            return rcm_order(graph, threads);
+        case Reorder::RABBIT:
+            return community_order(graph, threads);
+        default: {
+            std::vector<uint32_t> order(graph.get_nodes());
+            for (uint32_t p{ 0 }; p < graph.get_nodes(); p++) order[p] = p;
+            return order;
+        }
+    }
+}
+
+auto utility::permute_rows(
+    const std::span<const double> values,
+    const std::vector<uint32_t>& order,
+    const uint32_t width,
+    const uint32_t threads) -> std::vector<double> {
+    if (values.size() != static_cast<size_t>(order.size())*width) throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+
+    std::vector<double> permuted(values.size());
+    #pragma omp parallel for num_threads(threads)
+    for (size_t p = 0; p < order.size(); p++) {
+        std::copy_n(values.begin() + static_cast<size_t>(order[p])*width, width, permuted.begin() + p*width);
+    }
+
+    return permuted;
+}
+
+auto utility::restore_rows(
+    const std::span<const double> values,
+    const std::vector<uint32_t>& order,
+    const uint32_t width,
+    const uint32_t threads) -> std::vector<double> {
+    if (values.size() != static_cast<size_t>(order.size())*width) throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+
+    std::vector<double> restored(values.size());
+    #pragma omp parallel for num_threads(threads)
+    for (size_t p = 0; p < order.size(); p++) {
+        std::copy_n(values.begin() + p*width, width, restored.begin() + static_cast<size_t>(order[p])*width);
+    }
+
+    return restored;
+}
+
+template <typename Less>
+static auto sort_nodes(
+    std::vector<uint32_t>& nodes,
+    const Less& less,
+    const uint32_t threads) -> void {
+    const auto size{ nodes.size() };
+    std::vector<size_t> bounds(threads + 1);
+    for (uint32_t c{ 0 }; c <= threads; c++) bounds[c] = size*c/threads;
+
+    #pragma omp parallel for num_threads(threads)
+    for (uint32_t c = 0; c < threads; c++) {
+        std::sort(nodes.begin() + bounds[c], nodes.begin() + bounds[c + 1], less);
+    }
+
+    for (uint32_t width{ 1 }; width < threads; width *= 2) {
+        #pragma omp parallel for num_threads(threads)
+        for (uint32_t c = 0; c < threads; c += 2*width) {
+            const auto middle{ bounds[std::min(c + width, threads)] };
+            const auto end{ bounds[std::min(c + 2*width, threads)] };
+            std::inplace_merge(nodes.begin() + bounds[c], nodes.begin() + middle, nodes.begin() + end, less);
+        }
+    }
+}
+
+static auto make_adjacency(
+    const Graph& graph,
+    const uint32_t threads) -> Adjacency {
+    const auto nodes{ graph.get_nodes() };
+    const auto offsets{ graph.offsets() };
+    const auto sources{ graph.sources() };
+
+    // the outgoing links of every node, counted and then dealt out with atomics
+    std::vector<uint64_t> out_offsets(static_cast<uint64_t>(nodes) + 1, 0);
+    #pragma omp parallel for num_threads(threads)
+    for (uint64_t e = 0; e < sources.size(); e++) {
+        std::atomic_ref<uint64_t>(out_offsets[sources[e] + 1]).fetch_add(1, std::memory_order_relaxed);
+    }
+    for (uint32_t i{ 0 }; i < nodes; i++) out_offsets[i + 1] += out_offsets[i];
+
+    std::vector<uint32_t> targets(sources.size());
+    auto fill{ out_offsets };
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+    for (uint32_t i = 0; i < nodes; i++) {
+        for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+            targets[std::atomic_ref<uint64_t>(fill[sources[e]]).fetch_add(1, std::memory_order_relaxed)] = i;
+        }
+    }
+
+    Adjacency adjacency{};
+    adjacency.offsets.resize(static_cast<uint64_t>(nodes) + 1);
+    adjacency.offsets[0] = 0;
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+        adjacency.offsets[i + 1] = adjacency.offsets[i]
+            + (offsets[i + 1] - offsets[i]) + (out_offsets[i + 1] - out_offsets[i]);
+    }
+
+    // where the atomics put the targets depends on the timing, so every row gets sorted
+    adjacency.neighbors.resize(adjacency.offsets[nodes]);
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+    for (uint32_t i = 0; i < nodes; i++) {
+        const auto out{ adjacency.neighbors.begin() + adjacency.offsets[i] };
+        std::copy(sources.begin() + offsets[i], sources.begin() + offsets[i + 1], out);
+        std::copy(targets.begin() + out_offsets[i], targets.begin() + out_offsets[i + 1], out + (offsets[i + 1] - offsets[i]));
+        std::sort(out, adjacency.neighbors.begin() + adjacency.offsets[i + 1]);
+    }
+
+    return adjacency;
+}
+
+static auto degree_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t> {
+    const auto degrees{ graph.out_degrees() };
+
+    auto order{ reorder(graph, Reorder::NONE, threads) };
+    sort_nodes(order, [&](const uint32_t a, const uint32_t b) {
+        return degrees[a] != degrees[b] ? degrees[a] > degrees[b] : a < b;
+    }, threads);
+
+    return order;
+}
+
+static auto rcm_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t> {
+    const auto nodes{ graph.get_nodes() };
+    const auto adjacency{ make_adjacency(graph, threads) };
+    const auto degree{ [&](const uint32_t i) { return adjacency.offsets[i + 1] - adjacency.offsets[i]; } };
+    const auto by_degree{ [&](const uint32_t a, const uint32_t b) {
+        return degree(a) != degree(b) ? degree(a) < degree(b) : a < b;
+    } };
+
+    // every component starts from its node of the lowest degree
+    auto roots{ reorder(graph, Reorder::NONE, threads) };
+    sort_nodes(roots, by_degree, threads);
+
+    std::vector<uint32_t> order{};
+    order.reserve(nodes);
+    std::vector<uint8_t> placed(nodes, 0);
+    // the position of the first parent that found every node of the next level
+    std::vector<uint32_t> claims(nodes, unclaimed_gc);
+    std::vector<uint64_t> counts{};
+
+    // the children a parent at position `k` of `order` claimed, ordered by degree
+    const auto children{ [&](const uint32_t k, std::vector<uint32_t>& found) {
+        found.clear();
+        const auto v{ order[k] };
+        for (auto e{ adjacency.offsets[v] }; e < adjacency.offsets[v + 1]; e++) {
+            const auto u{ adjacency.neighbors[e] };
+            if (!placed[u] && claims[u] == k) found.push_back(u);
+        }
+        // a node that both links to and from the parent shows up twice
+        std::sort(found.begin(), found.end(), by_degree);
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+    } };
+
+    size_t cursor{ 0 };
+    while (order.size() < nodes) {
+        while (placed[roots[cursor]]) cursor++;
+        placed[roots[cursor]] = 1;
+        order.push_back(roots[cursor]);
+
+        auto level_begin{ order.size() - 1 };
+        while (level_begin < order.size()) {
+            const auto level_end{ order.size() };
+            const auto level{ static_cast<uint32_t>(level_end - level_begin) };
+            counts.assign(static_cast<size_t>(level) + 1, 0);
+
+            #pragma omp parallel num_threads(threads) if (level >= parallel_level_gc)
+            {
+                std::vector<uint32_t> found{};
+
+                #pragma omp for schedule(dynamic, 64)
+                for (uint32_t k = level_begin; k < level_end; k++) {
+                    const auto v{ order[k] };
+                    for (auto e{ adjacency.offsets[v] }; e < adjacency.offsets[v + 1]; e++) {
+                        const auto u{ adjacency.neighbors[e] };
+                        if (placed[u]) continue;
+
+                        std::atomic_ref<uint32_t> claim(claims[u]);
+                        auto seen{ claim.load(std::memory_order_relaxed) };
+                        while (k < seen && !claim.compare_exchange_weak(seen, k, std::memory_order_relaxed)) {}
+                    }
+                }
+
+                #pragma omp for schedule(dynamic, 64)
+                for (uint32_t k = level_begin; k < level_end; k++) {
+                    children(k, found);
+                    counts[k - level_begin + 1] = found.size();
+                }
+
+                #pragma omp single
+                {
+                    for (uint32_t k{ 0 }; k < level; k++) counts[k + 1] += counts[k];
+                    order.resize(level_end + counts[level]);
+                }
+
+                #pragma omp for schedule(dynamic, 64)
+                for (uint32_t k = level_begin; k < level_end; k++) {
+                    children(k, found);
+                    std::copy(found.begin(), found.end(), order.begin() + level_end + counts[k - level_begin]);
+                }
+
+                #pragma omp for
+                for (size_t p = level_end; p < order.size(); p++) placed[order[p]] = 1;
+            }
+
+            level_begin = level_end;
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+static auto community_order(
+    const Graph& graph,
+    const uint32_t threads) -> std::vector<uint32_t> {
+    const auto nodes{ graph.get_nodes() };
+    const auto degrees{ graph.out_degrees() };
+    const auto adjacency{ make_adjacency(graph, threads) };
+
+    std::vector<uint32_t> labels(nodes);
+    for (uint32_t i{ 0 }; i < nodes; i++) labels[i] = i;
+    auto next{ labels };
+
+    // every node takes the label most of its neighbors have, the smallest one on ties. The even
+    // nodes go first and the odd ones after them, which keeps two neighbors from swapping labels
+    // forever, and the result the same for any thread count
+    for (uint32_t round{ 0 }; round < label_rounds_gc; round++) {
+        bool changed{ false };
+        for (uint32_t parity{ 0 }; parity < 2; parity++) {
+            #pragma omp parallel num_threads(threads) reduction(||: changed)
+            {
+                std::vector<uint32_t> seen{};
+
+                #pragma omp for schedule(dynamic, 1024)
+                for (uint32_t i = parity; i < nodes; i += 2) {
+                    seen.assign(1, labels[i]);
+                    for (auto e{ adjacency.offsets[i] }; e < adjacency.offsets[i + 1]; e++) {
+                        seen.push_back(labels[adjacency.neighbors[e]]);
+                    }
+                    std::sort(seen.begin(), seen.end());
+
+                    auto best{ labels[i] };
+                    size_t most{ 0 };
+                    for (size_t k{ 0 }; k < seen.size();) {
+                        auto run{ k };
+                        while (run < seen.size() && seen[run] == seen[k]) run++;
+                        if (run - k > most) {
+                            most = run - k;
+                            best = seen[k];
+                        }
+                        k = run;
+                    }
+
+                    next[i] = best;
+                    changed = changed || best != labels[i];
+                }
+
+                // the labels of this half only change once all of it has looked at them
+                #pragma omp for
+                for (uint32_t i = parity; i < nodes; i += 2) {
+                    labels[i] = next[i];
+                }
+            }
+        }
+        if (!changed) break;
+    }
+
+    auto order{ reorder(graph, Reorder::NONE, threads) };
+    sort_nodes(order, [&](const uint32_t a, const uint32_t b) {
+        if (labels[a] != labels[b]) return labels[a] < labels[b];
+        return degrees[a] != degrees[b] ? degrees[a] > degrees[b] : a < b;
+    }, threads);
+
+    return order;
+}
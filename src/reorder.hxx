@@ -0,0 +1,57 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _REORDER_HXX_
+#define _REORDER_HXX_
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "types.hxx"
+
+// --- FUNCTION DECLARATIONS --- //
+
+namespace utility {
+  /// Work out a new order for the nodes of `graph` on `threads` threads. Node `order[p]`
+  /// becomes node `p`. The order only depends on the graph, not on the thread count
+  auto reorder(
+    const Graph& graph,
+    const Reorder how,
+    const uint32_t threads) -> std::vector<uint32_t>;
+
+  /// Bring `width` values per node from the original order of the nodes to `order`
+  auto permute_rows(
+    const std::span<const double> values,
+    const std::vector<uint32_t>& order,
+    const uint32_t width,
+    const uint32_t threads) -> std::vector<double>;
+
+  /// Bring `width` values per node from `order` back to the original order of the nodes
+  auto restore_rows(
+    const std::span<const double> values,
+    const std::vector<uint32_t>& order,
+    const uint32_t width,
+    const uint32_t threads) -> std::vector<double>;
+}
+
+#endif /* _REORDER_HXX_ */
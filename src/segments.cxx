@@ -0,0 +1,177 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "segments.hxx"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+
+#include <omp.h>
+#include <unistd.h>
+
+using namespace utility;
+
+// --- CONSTANTS --- //
+
+/// Where the kernel describes the caches of the first CPU
+constexpr const char* cache_dir_gc{ "/sys/devices/system/cpu/cpu0/cache" };
+/// What we assume when nothing tells us the size of the cache
+constexpr size_t default_cache_gc{ 8 << 20 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto Segments::build(
+    const Graph& graph,
+    const uint32_t width,
+    const std::vector<uint32_t>& bounds,
+    const uint32_t threads) -> Segments {
+    const auto nodes{ graph.get_nodes() };
+    const auto offsets{ graph.offsets() };
+    const auto sources{ graph.sources() };
+    const auto weights{ graph.weights() };
+
+    Segments segments{};
+    segments.width = std::max(width, 1u);
+    segments.count = static_cast<uint32_t>((static_cast<uint64_t>(nodes) + segments.width - 1)/segments.width);
+    segments.blocks = static_cast<uint32_t>(bounds.size() - 1);
+
+    const auto count{ segments.count };
+    const auto blocks{ segments.blocks };
+
+    // how many entries and links every block has in every segment
+    std::vector<uint64_t> entries(static_cast<size_t>(count)*blocks, 0);
+    std::vector<uint64_t> links(static_cast<size_t>(count)*blocks, 0);
+
+    // the links of every row are sorted by source, so the ones of a segment are the run of
+    // links up to the first source past it
+    const auto for_runs{ [&](const uint32_t i, const auto& fn) {
+        auto e{ offsets[i] };
+        while (e < offsets[i + 1]) {
+            const auto segment{ sources[e]/segments.width };
+            const auto limit{ static_cast<uint64_t>(segment + 1)*segments.width };
+            const auto run_end{ static_cast<uint64_t>(std::lower_bound(
+                sources.begin() + e, sources.begin() + offsets[i + 1], limit) - sources.begin()) };
+
+            fn(segment, e, run_end);
+            e = run_end;
+        }
+    } };
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t t = 0; t < blocks; t++) {
+        for (auto i{ bounds[t] }; i < bounds[t + 1]; i++) {
+            for_runs(i, [&](const uint32_t segment, const uint64_t begin, const uint64_t end) {
+                entries[static_cast<size_t>(segment)*blocks + t]++;
+                links[static_cast<size_t>(segment)*blocks + t] += end - begin;
+            });
+        }
+    }
+
+    // segment after segment, and block after block within each one
+    std::vector<uint64_t> entry_at(static_cast<size_t>(count)*blocks + 1, 0);
+    std::vector<uint64_t> link_at(static_cast<size_t>(count)*blocks + 1, 0);
+    for (size_t k{ 0 }; k < entries.size(); k++) {
+        entry_at[k + 1] = entry_at[k] + entries[k];
+        link_at[k + 1] = link_at[k] + links[k];
+    }
+
+    segments.firsts_data.resize(static_cast<size_t>(count)*(blocks + 1));
+    for (uint32_t s{ 0 }; s < count; s++) {
+        for (uint32_t t{ 0 }; t <= blocks; t++) {
+            segments.firsts_data[static_cast<size_t>(s)*(blocks + 1) + t] = entry_at[static_cast<size_t>(s)*blocks + t];
+        }
+    }
+
+    const auto total_entries{ entry_at.back() };
+    segments.rows_data.resize(total_entries);
+    segments.offsets_data.resize(total_entries + 1);
+    segments.sources_data.resize(graph.get_edges());
+    if (graph.is_weighted()) segments.weights_data.resize(graph.get_edges());
+    segments.offsets_data[total_entries] = graph.get_edges();
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t t = 0; t < blocks; t++) {
+        // where the next entry and link of this block go, in every segment
+        std::vector<uint64_t> next_entry(count);
+        std::vector<uint64_t> next_link(count);
+        for (uint32_t s{ 0 }; s < count; s++) {
+            next_entry[s] = entry_at[static_cast<size_t>(s)*blocks + t];
+            next_link[s] = link_at[static_cast<size_t>(s)*blocks + t];
+        }
+
+        for (auto i{ bounds[t] }; i < bounds[t + 1]; i++) {
+            for_runs(i, [&](const uint32_t segment, const uint64_t begin, const uint64_t end) {
+                const auto entry{ next_entry[segment]++ };
+                segments.rows_data[entry] = i;
+                segments.offsets_data[entry] = next_link[segment];
+
+                std::copy(sources.begin() + begin, sources.begin() + end, segments.sources_data.begin() + next_link[segment]);
+                if (graph.is_weighted())
+                    std::copy(weights.begin() + begin, weights.begin() + end, segments.weights_data.begin() + next_link[segment]);
+                next_link[segment] += end - begin;
+            });
+        }
+    }
+
+    return segments;
+}
+
+auto utility::last_level_cache() -> size_t {
+    // every `indexN` directory describes one cache, and we want the one of the highest level
+    size_t size{ 0 };
+    uint32_t level{ 0 };
+    for (uint32_t index{ 0 };; index++) {
+        const auto dir{ std::string(cache_dir_gc) + "/index" + std::to_string(index) };
+        std::ifstream level_file(dir + "/level");
+        std::ifstream size_file(dir + "/size");
+        std::ifstream type_file(dir + "/type");
+        if (!level_file || !size_file) break;
+
+        uint32_t this_level{ 0 };
+        std::string this_size{};
+        std::string type{};
+        level_file >> this_level;
+        size_file >> this_size;
+        type_file >> type;
+        if (type == "Instruction" || this_level < level) continue;
+
+        // sizes look like `2048K`
+        size_t value{ 0 };
+        const auto res{ std::from_chars(this_size.data(), this_size.data() + this_size.size(), value) };
+        if (res.ec != std::errc{}) continue;
+        if (res.ptr != this_size.data() + this_size.size()) {
+            if (*res.ptr == 'K') value <<= 10;
+            else if (*res.ptr == 'M') value <<= 20;
+        }
+
+        level = this_level;
+        size = value;
+    }
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    if (size == 0) {
+        const auto value{ sysconf(_SC_LEVEL3_CACHE_SIZE) };
+        if (value > 0) size = static_cast<size_t>(value);
+    }
+#endif
+
+    return size == 0 ? default_cache_gc : size;
+}
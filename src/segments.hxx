@@ -0,0 +1,105 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SEGMENTS_HXX_
+#define _SEGMENTS_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+
+// --- TYPES --- //
+
+namespace utility {
+  /// The links of a graph, regrouped by segments of `width` consecutive source nodes.
+  ///
+  /// A sweep that goes through the segments one after the other only gathers from
+  /// `width` ranks at a time, which fit in the cache, instead of from all of them.
+  ///
+  /// Within a segment, every row with links from it is an *entry*, and the entries are
+  /// grouped by the blocks of rows the segments were built for, in row order. Since the
+  /// rows of the graph are sorted by source, the sums of a row over the segments add up
+  /// its links in the same order as a sweep over the whole row does
+  class Segments {
+    private:
+      uint32_t              width{ 0 };
+      uint32_t              count{ 0 };
+      uint32_t              blocks{ 0 };
+      /// The row of every entry
+      std::vector<uint32_t> rows_data{};
+      /// Where the links of every entry start in `sources_data`. Has one more element
+      std::vector<uint64_t> offsets_data{};
+      std::vector<uint32_t> sources_data{};
+      /// Empty for unweighted graphs
+      std::vector<double>   weights_data{};
+      /// Where the entries of block `t` in segment `s` start, at `s*(blocks + 1) + t`
+      std::vector<uint64_t> firsts_data{};
+
+    public:
+      /// Regroup the links of `graph`, for the blocks of rows `[bounds[t], bounds[t + 1])`
+      static auto build(
+        const Graph& graph,
+        const uint32_t width,
+        const std::vector<uint32_t>& bounds,
+        const uint32_t threads) -> Segments;
+
+      inline auto get_width() const -> uint32_t {
+        return this->width;
+      }
+
+      inline auto get_count() const -> uint32_t {
+        return this->count;
+      }
+
+      /// The entries of block `block` in segment `segment`
+      inline auto first(
+        const uint32_t segment,
+        const uint32_t block) const -> uint64_t {
+        return this->firsts_data[static_cast<size_t>(segment)*(this->blocks + 1) + block];
+      }
+
+      inline auto rows() const -> std::span<const uint32_t> {
+        return this->rows_data;
+      }
+
+      inline auto offsets() const -> std::span<const uint64_t> {
+        return this->offsets_data;
+      }
+
+      inline auto sources() const -> std::span<const uint32_t> {
+        return this->sources_data;
+      }
+
+      inline auto weights() const -> std::span<const double> {
+        return this->weights_data;
+      }
+  };
+
+  // --- FUNCTION DECLARATIONS --- //
+
+  /// The size of the last level cache in bytes, out of sysfs, or a guess if that is not there
+  auto last_level_cache() -> size_t;
+}
+
+#endif /* _SEGMENTS_HXX_ */
@@ -0,0 +1,1235 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solver.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <omp.h>
+
+#include "kernels.hxx"
+#include "numa.hxx"
+#include "profile.hxx"
+#include "ranks.hxx"
+#include "segments.hxx"
+
+using Error     = utility::Error;
+using ErrorCode = utility::Error::ErrorCode;
+using Graph     = utility::Graph;
+
+using namespace exe::kernels;
+
+// --- TYPES --- //
+
+/// The per-vector sums of a batched sweep over a block of rows
+struct BatchPartial {
+  std::vector<double> sum{};
+  std::vector<double> peak{};
+  std::vector<double> dangling{};
+  std::vector<double> mass{};
+
+  BatchPartial(const uint32_t width = 0)
+    : sum(width), peak(width), dangling(width), mass(width) {}
+};
+
+/// Which vectors of a batch are still being iterated
+struct BatchState {
+  /// The vector every column of the block belongs to
+  std::vector<uint32_t> active{};
+  /// The column of every vector in the block, or -1 once it is done
+  std::vector<int32_t>  slots{};
+  std::vector<double>   coefficients{};
+  /// The columns that stay in the block, and the ones that leave it, after an iteration
+  std::vector<uint32_t> kept{};
+  std::vector<uint32_t> done{};
+};
+
+// --- CONSTANTS --- //
+
+/// How much the push threshold drops after every round
+constexpr double   push_drop_gc{ 4.0 };
+/// How many nodes looking for residuals above the threshold costs as much as pushing over a link
+constexpr uint32_t push_scan_cost_gc{ 8 };
+/// How many times the unit roundoff of the scaled ranks a residual gets down to before the
+/// rounding of every link is about all that is left of it
+constexpr double   precision_floor_gc{ 16.0 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+/// Compute rows `[begin, end)` of the next iterate out of the current one
+template <typename Scaled>
+static auto sweep_rows(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial;
+
+/// Compute rows `[begin, end)` of the next iterate out of the current one, going through
+/// the links of block `block` one source segment at a time
+template <typename Scaled>
+static auto sweep_rows_blocked(
+  const Graph& trans_matrix,
+  const uint32_t block,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial;
+
+/// Compute rows `[begin, end)` of the next iterate in place, Gauss-Seidel style: rows
+/// of the block read the ranks this sweep already produced, all others those of `current`
+static auto sweep_rows_gs(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial;
+
+/// Compute rows `[begin, end)` of the only iterate in place, reading the latest
+/// ranks of every row, even the ones other threads are updating
+static auto sweep_rows_async(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& iterate,
+  const Step& step) -> Partial;
+
+/// Whether a sweep gathering reduced-precision ranks, which got the residual down to `residual`
+/// from `last`, has gone about as far as that precision allows
+static inline auto needs_double(
+  const Step& step,
+  const utility::Options& options,
+  const double residual,
+  const double last) -> bool;
+
+/// Whether the sweeps of `options` go through the links one source segment at a time
+static inline auto is_blocked(const utility::Options& options) -> bool;
+
+/// Set rows `[begin, end)` of the first block to the vectors of the batch
+static auto init_batch_rows(
+  const Graph& trans_matrix,
+  const exe::Batch& batch,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& first,
+  const BatchState& state,
+  BatchPartial& partial) -> void;
+
+/// Compute rows `[begin, end)` of the next block out of the current one, for every active vector
+static auto sweep_batch_rows(
+  const Graph& trans_matrix,
+  const exe::Batch& batch,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const BatchState& state,
+  const Step& step,
+  std::vector<double>& row,
+  BatchPartial& partial) -> void;
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto exe::kernels::make_step(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const std::span<const double> teleport) -> Step {
+  if (!teleport.empty() && teleport.size() != trans_matrix.get_nodes())
+    throw Error{ std::string_view(__FILE__), ErrorCode::WRONG_DIMS_ERR };
+
+  return {
+    .damping{ options.dump_fac },
+    .coefficient{ 0.0 },
+    .teleport{ teleport },
+    .uniform{ 1.0/static_cast<double>(trans_matrix.get_nodes()) },
+    .norm{ options.norm },
+    .method{ options.method },
+  };
+}
+
+static inline auto is_blocked(const utility::Options& options) -> bool {
+  // the in-place methods read the ranks of this very sweep, which do not stay put within a segment
+  return options.block_nodes != 0 && options.method == utility::Method::POWER;
+}
+
+static inline auto needs_double(
+  const Step& step,
+  const utility::Options& options,
+  const double residual,
+  const double last) -> bool {
+  // the residual stops dropping once the rounding of the scaled ranks is all that changes
+  // between two sweeps. Reaching the tolerance also hands over, since the rounding may be
+  // what kept the residual down
+  const auto roundoff{ step.precision == utility::Precision::BF16 ? 0x1p-8 : 0x1p-24 };
+  return residual < options.tolerance || residual <= precision_floor_gc*roundoff || residual >= last;
+}
+
+auto exe::kernels::init_rows(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& first,
+  const Step& step,
+  const std::span<const double> initial) -> Partial {
+  const auto degrees{ trans_matrix.out_degrees() };
+  Partial partial{};
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    const auto value{ !initial.empty() ? initial[i] : step.teleport.empty() ? step.uniform : step.teleport[i] };
+
+    first.ranks[i] = value;
+    switch (step.precision) {
+      case utility::Precision::FLOAT:
+        first.scaled_float[i] = narrow<float>(scale_entry(trans_matrix, value, i));
+        break;
+      case utility::Precision::BF16:
+        first.scaled_bf16[i] = narrow<Bf16>(scale_entry(trans_matrix, value, i));
+        break;
+      default:
+        first.scaled[i] = scale_entry(trans_matrix, value, i);
+    }
+
+    if (degrees[i] == 0) partial.dangling += value;
+    partial.mass += value;
+  }
+
+  return partial;
+}
+
+template <typename Scaled>
+static auto sweep_rows(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial {
+  const auto* const scaled{ scaled_of<Scaled>(current) };
+  Partial partial{};
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    finish_row<Scaled>(trans_matrix, i, multiply_row(trans_matrix, scaled, i), current, next, step, partial);
+  }
+
+  return partial;
+}
+
+template <typename Scaled>
+static auto sweep_rows_blocked(
+  const Graph& trans_matrix,
+  const uint32_t block,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial {
+  const auto* const scaled{ scaled_of<Scaled>(current) };
+  const auto& segments{ *step.segments };
+  const auto rows{ segments.rows() };
+  const auto offsets{ segments.offsets() };
+  const auto sources{ segments.sources() };
+  const auto weights{ segments.weights() };
+  Partial partial{};
+
+  std::fill(step.sums + begin, step.sums + end, 0.0);
+
+  // every segment only reads its own slice of the scaled ranks, which stays in the cache
+  // while the rows of the block pick up their links from it. A row gets its links in the
+  // same order as in `multiply_row`, so the sums come out the same to the last bit
+  for (uint32_t s{ 0 }; s < segments.get_count(); s++) {
+    for (auto entry{ segments.first(s, block) }; entry < segments.first(s, block + 1); entry++) {
+      double sum{ step.sums[rows[entry]] };
+      if (trans_matrix.is_weighted()) {
+        for (auto e{ offsets[entry] }; e < offsets[entry + 1]; e++) {
+          sum += weights[e]*widen(scaled[sources[e]]);
+        }
+      } else {
+        for (auto e{ offsets[entry] }; e < offsets[entry + 1]; e++) {
+          sum += widen(scaled[sources[e]]);
+        }
+      }
+      step.sums[rows[entry]] = sum;
+    }
+  }
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    finish_row<Scaled>(trans_matrix, i, step.sums[i], current, next, step, partial);
+  }
+
+  return partial;
+}
+
+static auto sweep_rows_gs(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial {
+  const auto offsets{ trans_matrix.offsets() };
+  const auto sources{ trans_matrix.sources() };
+  const auto weights{ trans_matrix.weights() };
+  const auto degrees{ trans_matrix.out_degrees() };
+  Partial partial{};
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    double sum{ 0.0 };
+    for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+      const auto source{ sources[e] };
+      // the block is the only part of `next` written so far
+      const auto scaled{ source >= begin && source < i ? next.scaled[source] : current.scaled[source] };
+      sum += trans_matrix.is_weighted() ? weights[e]*scaled : scaled;
+    }
+
+    const auto teleport{ step.teleport.empty() ? step.uniform : step.teleport[i] };
+    const auto value{ step.damping*sum + step.coefficient*teleport };
+    const auto diff{ value - current.ranks[i] };
+
+    next.ranks[i] = value;
+    next.scaled[i] = scale_entry(trans_matrix, value, i);
+
+    partial.sum += residual_term(step.norm, diff);
+    partial.peak = std::max(partial.peak, std::abs(diff));
+    if (degrees[i] == 0) partial.dangling += value;
+    partial.mass += value;
+  }
+
+  return partial;
+}
+
+static auto sweep_rows_async(
+  const Graph& trans_matrix,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& iterate,
+  const Step& step) -> Partial {
+  static_assert(std::atomic_ref<double>::is_always_lock_free);
+
+  const auto offsets{ trans_matrix.offsets() };
+  const auto sources{ trans_matrix.sources() };
+  const auto weights{ trans_matrix.weights() };
+  const auto degrees{ trans_matrix.out_degrees() };
+  Partial partial{};
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    // other threads write the scaled ranks of their rows while we read them. Relaxed
+    // atomics are plain loads and stores on x86, and every value read is one that got
+    // written, older or newer, which the iteration converges with all the same
+    double sum{ 0.0 };
+    for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+      const auto scaled{ std::atomic_ref<double>(iterate.scaled[sources[e]]).load(std::memory_order_relaxed) };
+      sum += trans_matrix.is_weighted() ? weights[e]*scaled : scaled;
+    }
+
+    const auto teleport{ step.teleport.empty() ? step.uniform : step.teleport[i] };
+    const auto value{ step.damping*sum + step.coefficient*teleport };
+    // only this thread ever touches the ranks themselves
+    const auto diff{ value - iterate.ranks[i] };
+
+    iterate.ranks[i] = value;
+    std::atomic_ref<double>(iterate.scaled[i]).store(scale_entry(trans_matrix, value, i), std::memory_order_relaxed);
+
+    partial.sum += residual_term(step.norm, diff);
+    partial.peak = std::max(partial.peak, std::abs(diff));
+    if (degrees[i] == 0) partial.dangling += value;
+    partial.mass += value;
+  }
+
+  return partial;
+}
+
+auto exe::kernels::sweep(
+  const Graph& trans_matrix,
+  const uint32_t block,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const Step& step) -> Partial {
+  switch (step.method) {
+    case utility::Method::GAUSS_SEIDEL:
+      return sweep_rows_gs(trans_matrix, begin, end, current, next, step);
+    case utility::Method::ASYNC:
+      return sweep_rows_async(trans_matrix, begin, end, current, step);
+    default:
+      break;
+  }
+
+  switch (step.precision) {
+    case utility::Precision::FLOAT:
+      if (step.segments != nullptr) return sweep_rows_blocked<float>(trans_matrix, block, begin, end, current, next, step);
+      return sweep_rows<float>(trans_matrix, begin, end, current, next, step);
+    case utility::Precision::BF16:
+      if (step.segments != nullptr) return sweep_rows_blocked<Bf16>(trans_matrix, block, begin, end, current, next, step);
+      return sweep_rows<Bf16>(trans_matrix, begin, end, current, next, step);
+    default:
+      if (step.segments != nullptr) return sweep_rows_blocked<double>(trans_matrix, block, begin, end, current, next, step);
+      return sweep_rows<double>(trans_matrix, begin, end, current, next, step);
+  }
+}
+
+auto exe::kernels::combine(const std::vector<Partial>& partials) -> Partial {
+  Partial total{};
+  for (const auto& partial : partials) {
+    total.sum += partial.sum;
+    total.peak = std::max(total.peak, partial.peak);
+    total.dangling += partial.dangling;
+    total.mass += partial.mass;
+  }
+
+  return total;
+}
+
+auto exe::pagerank_serial(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const std::span<const double> teleport,
+  const std::span<const double> initial) -> Solution {
+  const auto nodes{ trans_matrix.get_nodes() };
+  const auto bounds{ trans_matrix.partition(options.jobs) };
+  if (!initial.empty() && initial.size() != nodes)
+    throw Error{ std::string_view(__FILE__), ErrorCode::WRONG_DIMS_ERR };
+
+  auto step{ make_step(trans_matrix, options, teleport) };
+  // the in-place methods read ranks of the very sweep that writes them, and keep them in double precision
+  step.precision = options.method == utility::Method::POWER ? options.precision : utility::Precision::DOUBLE;
+
+  // the scaled ranks in double precision are only there once the reduced ones are done with
+  const auto reduced{ step.precision != utility::Precision::DOUBLE };
+  std::vector<double> ranks[2]{ std::vector<double>(nodes), std::vector<double>(nodes) };
+  std::vector<double> scaled[2]{ std::vector<double>(reduced ? 0 : nodes), std::vector<double>(reduced ? 0 : nodes) };
+  std::vector<float> scaled_float[2]{};
+  std::vector<Bf16> scaled_bf16[2]{};
+  for (uint32_t k{ 0 }; k < 2; k++) {
+    if (step.precision == utility::Precision::FLOAT) scaled_float[k].resize(nodes);
+    if (step.precision == utility::Precision::BF16) scaled_bf16[k].resize(nodes);
+  }
+  const auto iterate{ [&](const uint32_t k) -> Iterate {
+    return { ranks[k].data(), scaled[k].data(), scaled_float[k].data(), scaled_bf16[k].data() };
+  } };
+  std::vector<Partial> partials(options.jobs);
+
+  utility::Segments segments{};
+  std::vector<double> sums{};
+  if (is_blocked(options)) {
+    const utility::Profiler::ScopedPhase phase("blocking");
+    segments = utility::Segments::build(trans_matrix, options.block_nodes, bounds, 1);
+    sums.resize(nodes);
+    step.segments = &segments;
+    step.sums = sums.data();
+  }
+  for (uint32_t t{ 0 }; t < options.jobs; t++) {
+    partials[t] = init_rows(trans_matrix, bounds[t], bounds[t + 1], iterate(0), step, initial);
+  }
+  auto total{ combine(partials) };
+
+  auto& profiler{ utility::Profiler::get() };
+  auto& checkpoint{ utility::Checkpoint::get() };
+
+  // the in-place methods only ever have one iterate, for all blocks
+  const uint32_t flip{ options.method == utility::Method::ASYNC ? 0u : 1u };
+
+  Solution solution{};
+  uint32_t current{ 0 };
+  while (solution.iterations < options.iterations) {
+    const utility::Profiler::ScopedPhase phase(
+      profiler.is_enabled() ? "iteration " + std::to_string(solution.iterations) : std::string{});
+
+    step.coefficient = next_coefficient(step, total);
+    for (uint32_t t{ 0 }; t < options.jobs; t++) {
+      partials[t] = sweep(
+        trans_matrix,
+        t, bounds[t], bounds[t + 1],
+        iterate(current),
+        iterate(current ^ flip),
+        step);
+    }
+    total = combine(partials);
+
+    current ^= flip;
+    const auto last{ solution.residual };
+    solution.residual = finish_residual(options.norm, total);
+    solution.iterations++;
+
+    if (auto* const saved{ checkpoint.acquire(solution.iterations, nodes) }) {
+      for (uint32_t i{ 0 }; i < nodes; i++) saved[i] = ranks[current][i]/total.mass;
+      checkpoint.submit(solution.iterations, solution.residual);
+    }
+
+    if (step.precision == utility::Precision::DOUBLE) {
+      if (solution.residual < options.tolerance) break;
+      continue;
+    }
+
+    solution.reduced++;
+    if (solution.iterations > 1 && needs_double(step, options, solution.residual, last)) {
+      // the ranks themselves were always kept in double precision, so the scaled
+      // ones the next sweep gathers come out of them with no rounding at all
+      for (auto& vec : scaled) vec.resize(nodes);
+      for (uint32_t i{ 0 }; i < nodes; i++) scaled[current][i] = scale_entry(trans_matrix, ranks[current][i], i);
+      for (uint32_t k{ 0 }; k < 2; k++) {
+        scaled_float[k] = {};
+        scaled_bf16[k] = {};
+      }
+      step.precision = utility::Precision::DOUBLE;
+    }
+  }
+
+  solution.ranks = std::move(ranks[current]);
+  for (auto& rank : solution.ranks) rank /= total.mass;
+
+  return solution;
+}
+
+auto exe::pagerank_parallel(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const std::span<const double> teleport,
+  const std::span<const double> initial) -> Solution {
+  const auto nodes{ trans_matrix.get_nodes() };
+  const auto bounds{ trans_matrix.partition(options.jobs) };
+  if (!initial.empty() && initial.size() != nodes)
+    throw Error{ std::string_view(__FILE__), ErrorCode::WRONG_DIMS_ERR };
+
+  // left uninitialized, so that the first thread to touch every page (the
+  // one that owns its rows) is the one whose node it gets placed on
+  std::unique_ptr<double[]> ranks[2]{
+    std::make_unique_for_overwrite<double[]>(nodes), std::make_unique_for_overwrite<double[]>(nodes) };
+  std::vector<Partial> partials(options.jobs);
+
+  auto step{ make_step(trans_matrix, options, teleport) };
+  step.precision = options.method == utility::Method::POWER ? options.precision : utility::Precision::DOUBLE;
+  Partial total{};
+
+  // only the scaled ranks of the precision the sweeps gather are there
+  std::unique_ptr<double[]> scaled[2]{};
+  std::unique_ptr<float[]> scaled_float[2]{};
+  std::unique_ptr<Bf16[]> scaled_bf16[2]{};
+  for (uint32_t k{ 0 }; k < 2; k++) {
+    switch (step.precision) {
+      case utility::Precision::FLOAT:
+        scaled_float[k] = std::make_unique_for_overwrite<float[]>(nodes);
+        break;
+      case utility::Precision::BF16:
+        scaled_bf16[k] = std::make_unique_for_overwrite<Bf16[]>(nodes);
+        break;
+      default:
+        scaled[k] = std::make_unique_for_overwrite<double[]>(nodes);
+    }
+  }
+  const auto iterate{ [&](const uint32_t k) -> Iterate {
+    return { ranks[k].get(), scaled[k].get(), scaled_float[k].get(), scaled_bf16[k].get() };
+  } };
+  // set once the reduced precision has gone as far as it can
+  bool widening{ false };
+
+  utility::Segments segments{};
+  std::unique_ptr<double[]> sums{};
+  if (is_blocked(options)) {
+    const utility::Profiler::ScopedPhase phase("blocking");
+    segments = utility::Segments::build(trans_matrix, options.block_nodes, bounds, options.jobs);
+    // every sweep clears the sums of its own rows first
+    sums = std::make_unique_for_overwrite<double[]>(nodes);
+    step.segments = &segments;
+    step.sums = sums.get();
+  }
+
+  auto& profiler{ utility::Profiler::get() };
+
+  const uint32_t flip{ options.method == utility::Method::ASYNC ? 0u : 1u };
+
+  auto& checkpoint{ utility::Checkpoint::get() };
+  double* saved{ nullptr };
+
+  auto& numa{ utility::Numa::get() };
+
+  Solution solution{};
+  solution.ranks.resize(nodes);
+  bool converged{ false };
+
+  #pragma omp parallel num_threads(options.jobs)
+  {
+    // every thread always works on the same rows, balanced by their links
+    const auto thread{ static_cast<uint32_t>(omp_get_thread_num()) };
+    const auto begin{ bounds[thread] };
+    const auto end{ bounds[thread + 1] };
+
+    partials[thread] = init_rows(trans_matrix, begin, end, iterate(0), step, initial);
+
+    #pragma omp barrier
+
+    #pragma omp single
+    {
+      total = combine(partials);
+      step.coefficient = next_coefficient(step, total);
+      profiler.begin_phase("iteration 0");
+    }
+
+    // every thread keeps track of which buffer is current on its own, so
+    // swapping them needs no synchronization
+    uint32_t current{ 0 };
+    while (!converged && solution.iterations < options.iterations) {
+      {
+        const utility::Profiler::ScopedSpan span("sweep");
+        partials[thread] = sweep(
+          trans_matrix,
+          thread, begin, end,
+          iterate(current),
+          iterate(current ^ flip),
+          step);
+      }
+      current ^= flip;
+
+      #pragma omp barrier
+
+      // the partial sums are combined in thread order, so that the
+      // result is the same on every run with the same amount of threads
+      #pragma omp single
+      {
+        total = combine(partials);
+        step.coefficient = next_coefficient(step, total);
+
+        const auto last{ solution.residual };
+        solution.residual = finish_residual(options.norm, total);
+        solution.iterations++;
+        converged = step.precision == utility::Precision::DOUBLE && solution.residual < options.tolerance;
+        saved = checkpoint.acquire(solution.iterations, nodes);
+
+        if (step.precision != utility::Precision::DOUBLE) {
+          solution.reduced++;
+          widening = solution.iterations > 1 && needs_double(step, options, solution.residual, last);
+          if (widening) {
+            scaled[0] = std::make_unique_for_overwrite<double[]>(nodes);
+            scaled[1] = std::make_unique_for_overwrite<double[]>(nodes);
+          }
+        }
+
+        // every thread is past its sweep here, so this is where one iteration ends and the next starts
+        profiler.end_phase();
+        if (!converged && solution.iterations < options.iterations)
+          profiler.begin_phase("iteration " + std::to_string(solution.iterations));
+      }
+
+      // every thread copies its own rows, and the file gets written in the background
+      if (saved != nullptr) {
+        for (uint32_t i{ begin }; i < end; i++) saved[i] = ranks[current][i]/total.mass;
+
+        #pragma omp barrier
+
+        #pragma omp single
+        checkpoint.submit(solution.iterations, solution.residual);
+      }
+
+      // the ranks themselves were always kept in double precision, so the scaled ones the
+      // next sweep gathers come out of them with no rounding at all. Every thread does its rows
+      if (widening) {
+        for (uint32_t i{ begin }; i < end; i++) scaled[current][i] = scale_entry(trans_matrix, ranks[current][i], i);
+
+        #pragma omp barrier
+
+        #pragma omp single
+        {
+          for (uint32_t k{ 0 }; k < 2; k++) {
+            scaled_float[k].reset();
+            scaled_bf16[k].reset();
+          }
+          step.precision = utility::Precision::DOUBLE;
+          widening = false;
+        }
+      }
+    }
+
+    for (uint32_t i{ begin }; i < end; i++) solution.ranks[i] = ranks[current][i]/total.mass;
+
+    #pragma omp single
+    {
+      const auto bytes{ static_cast<size_t>(nodes)*sizeof(double) };
+      numa.record("ranks", ranks[0].get(), bytes);
+      numa.record("scaled ranks", scaled[0].get(), scaled[0] ? bytes : 0);
+      if (flip != 0 && solution.iterations != 0) {
+        numa.record("next ranks", ranks[1].get(), bytes);
+        numa.record("next scaled", scaled[1].get(), scaled[1] ? bytes : 0);
+      }
+    }
+  }
+
+  return solution;
+}
+
+auto exe::time_sweeps(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const uint32_t sweeps) -> double {
+  const auto nodes{ trans_matrix.get_nodes() };
+  const auto bounds{ trans_matrix.partition(options.jobs) };
+
+  std::unique_ptr<double[]> ranks[2]{
+    std::make_unique_for_overwrite<double[]>(nodes), std::make_unique_for_overwrite<double[]>(nodes) };
+  std::unique_ptr<double[]> scaled[2]{
+    std::make_unique_for_overwrite<double[]>(nodes), std::make_unique_for_overwrite<double[]>(nodes) };
+  const Iterate current{ ranks[0].get(), scaled[0].get() };
+  const Iterate next{ ranks[1].get(), scaled[1].get() };
+
+  auto step{ make_step(trans_matrix, options, {}) };
+  step.method = utility::Method::POWER;
+  step.coefficient = 1.0 - step.damping;
+
+  double best{ std::numeric_limits<double>::infinity() };
+  std::chrono::steady_clock::time_point start{};
+
+  // every sweep starts from the same iterate, since only the time matters
+  #pragma omp parallel num_threads(options.do_serial ? 1 : options.jobs)
+  {
+    #pragma omp for schedule(static, 1)
+    for (uint32_t t = 0; t < options.jobs; t++) {
+      init_rows(trans_matrix, bounds[t], bounds[t + 1], current, step, {});
+    }
+
+    for (uint32_t s{ 0 }; s < sweeps; s++) {
+      #pragma omp single
+      start = std::chrono::steady_clock::now();
+
+      #pragma omp for schedule(static, 1)
+      for (uint32_t t = 0; t < options.jobs; t++) {
+        sweep_rows<double>(trans_matrix, bounds[t], bounds[t + 1], current, next, step);
+      }
+
+      #pragma omp single
+      best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+  }
+
+  return best;
+}
+
+auto exe::pagerank_push(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const std::span<const double> teleport,
+  const std::span<const double> initial) -> Solution {
+  const auto nodes{ trans_matrix.get_nodes() };
+  const auto offsets{ trans_matrix.offsets() };
+  const auto sources{ trans_matrix.sources() };
+  const auto weights{ trans_matrix.weights() };
+  const auto degrees{ trans_matrix.out_degrees() };
+  const auto threads{ options.do_serial ? 1 : options.jobs };
+
+  if (initial.size() != nodes) throw Error{ std::string_view(__FILE__), ErrorCode::WRONG_DIMS_ERR };
+
+  auto& profiler{ utility::Profiler::get() };
+  profiler.begin_phase("push");
+
+  // the residual of the warm start, `G*x - x`, out of one regular sweep
+  auto step{ make_step(trans_matrix, options, teleport) };
+  std::vector<double> ranks(initial.begin(), initial.end());
+  std::vector<double> scaled(nodes);
+  std::vector<double> residuals(nodes);
+  double dangling{ 0.0 };
+
+  #pragma omp parallel for num_threads(threads) reduction(+: dangling)
+  for (uint32_t i = 0; i < nodes; i++) {
+    scaled[i] = scale_entry(trans_matrix, ranks[i], i);
+    if (degrees[i] == 0) dangling += ranks[i];
+  }
+
+  step.coefficient = step.damping*dangling + (1.0 - step.damping);
+  #pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+  for (uint32_t i = 0; i < nodes; i++) {
+    const auto teleport_i{ step.teleport.empty() ? step.uniform : step.teleport[i] };
+    residuals[i] = step.damping*multiply_row(trans_matrix, scaled.data(), i) + step.coefficient*teleport_i - ranks[i];
+  }
+
+  // pushing goes along the outgoing links, so we need the transpose of the matrix. It
+  // is built in row order, so that the pushes are the same on every run
+  std::vector<uint64_t> out_offsets(static_cast<uint64_t>(nodes) + 1, 0);
+  for (uint32_t j{ 0 }; j < nodes; j++) out_offsets[j + 1] = out_offsets[j] + degrees[j];
+
+  std::vector<uint32_t> targets(trans_matrix.get_edges());
+  std::vector<double> shares(trans_matrix.is_weighted() ? trans_matrix.get_edges() : 0);
+  {
+    auto fill{ out_offsets };
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+      for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+        const auto at{ fill[sources[e]]++ };
+        targets[at] = i;
+        if (trans_matrix.is_weighted()) shares[at] = weights[e];
+      }
+    }
+  }
+
+  // below this, a residual is too small to bother with. The sweeps that follow take care of it
+  const auto floor{ options.tolerance/static_cast<double>(nodes) };
+  // and after touching about as many links as a sweep does, the sweeps are the cheaper way
+  const auto budget{ trans_matrix.get_edges() + nodes };
+
+  double threshold{ 0.0 };
+  for (const auto residual : residuals) threshold = std::max(threshold, std::abs(residual));
+
+  std::vector<uint32_t> queue{};
+  std::vector<bool> queued(nodes, false);
+
+  Solution solution{};
+  uint64_t work{ 0 };
+  // the largest residuals go first: every round pushes all the residuals above a
+  // threshold, which then drops, so that the budget goes to the nodes that matter
+  while (work < budget && threshold > floor) {
+    threshold = std::max(threshold/push_drop_gc, floor);
+
+    queue.clear();
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+      if (std::abs(residuals[i]) > threshold) {
+        queue.push_back(i);
+        queued[i] = true;
+      }
+    }
+    // finding them is a pass over the nodes, but not over their links
+    work += nodes/push_scan_cost_gc;
+
+    // the rank pushed to nodes without outgoing links goes back along the teleportation
+    // vector, to every node at once, so the sweeps hand it out instead
+    for (size_t head{ 0 }; head < queue.size(); head++) {
+      const auto u{ queue[head] };
+      queued[u] = false;
+      if (work >= budget) continue;
+
+      const auto delta{ residuals[u] };
+      if (std::abs(delta) <= threshold) continue;
+
+      ranks[u] += delta;
+      residuals[u] = 0.0;
+      solution.pushes++;
+      work += degrees[u] + 1;
+
+      for (auto e{ out_offsets[u] }; e < out_offsets[u + 1]; e++) {
+        const auto w{ targets[e] };
+        const auto share{ trans_matrix.is_weighted() ? shares[e] : 1.0/static_cast<double>(degrees[u]) };
+
+        residuals[w] += step.damping*delta*share;
+        if (!queued[w] && std::abs(residuals[w]) > threshold) {
+          queue.push_back(w);
+          queued[w] = true;
+        }
+      }
+    }
+  }
+
+  // the sweeps expect ranks that sum up to 1
+  double mass{ 0.0 };
+  for (const auto rank : ranks) mass += rank;
+  for (auto& rank : ranks) rank /= mass;
+
+  profiler.end_phase();
+
+  const auto pushes{ solution.pushes };
+  solution = (options.do_serial ? pagerank_serial : pagerank_parallel)(trans_matrix, options, teleport, ranks);
+  solution.pushes = pushes;
+
+  return solution;
+}
+
+static auto init_batch_rows(
+  const Graph& trans_matrix,
+  const exe::Batch& batch,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& first,
+  const BatchState& state,
+  BatchPartial& partial) -> void {
+  const auto width{ static_cast<uint32_t>(state.active.size()) };
+  const auto degrees{ trans_matrix.out_degrees() };
+
+  std::fill(partial.dangling.begin(), partial.dangling.end(), 0.0);
+  std::fill(partial.mass.begin(), partial.mass.end(), 0.0);
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    auto* const ranks{ first.ranks + static_cast<uint64_t>(i)*width };
+    auto* const scaled{ first.scaled + static_cast<uint64_t>(i)*width };
+
+    std::fill(ranks, ranks + width, 0.0);
+    for (auto s{ batch.offsets[i] }; s < batch.offsets[i + 1]; s++) {
+      ranks[state.slots[batch.vectors[s]]] += batch.weights[s];
+    }
+
+    for (uint32_t k{ 0 }; k < width; k++) {
+      scaled[k] = scale_entry(trans_matrix, ranks[k], i);
+      if (degrees[i] == 0) partial.dangling[k] += ranks[k];
+      partial.mass[k] += ranks[k];
+    }
+  }
+}
+
+static auto sweep_batch_rows(
+  const Graph& trans_matrix,
+  const exe::Batch& batch,
+  const uint32_t begin,
+  const uint32_t end,
+  const Iterate& current,
+  const Iterate& next,
+  const BatchState& state,
+  const Step& step,
+  std::vector<double>& row,
+  BatchPartial& partial) -> void {
+  const auto width{ static_cast<uint32_t>(state.active.size()) };
+  const auto offsets{ trans_matrix.offsets() };
+  const auto sources{ trans_matrix.sources() };
+  const auto weights{ trans_matrix.weights() };
+  const auto degrees{ trans_matrix.out_degrees() };
+
+  auto* const sum{ partial.sum.data() };
+  auto* const peak{ partial.peak.data() };
+  auto* const dangling{ partial.dangling.data() };
+  auto* const mass{ partial.mass.data() };
+  auto* const acc{ row.data() };
+
+  std::fill(partial.sum.begin(), partial.sum.begin() + width, 0.0);
+  std::fill(partial.peak.begin(), partial.peak.begin() + width, 0.0);
+  std::fill(partial.dangling.begin(), partial.dangling.begin() + width, 0.0);
+  std::fill(partial.mass.begin(), partial.mass.begin() + width, 0.0);
+
+  for (uint32_t i{ begin }; i < end; i++) {
+    std::fill(acc, acc + width, 0.0);
+
+    // every link is read once, and used for all the vectors in the
+    // contiguous entries of its source, which the compiler vectorizes
+    if (trans_matrix.is_weighted()) {
+      for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+        const auto* const source{ current.scaled + static_cast<uint64_t>(sources[e])*width };
+        const auto weight{ weights[e] };
+        #pragma omp simd
+        for (uint32_t k = 0; k < width; k++) acc[k] += weight*source[k];
+      }
+    } else {
+      for (auto e{ offsets[i] }; e < offsets[i + 1]; e++) {
+        const auto* const source{ current.scaled + static_cast<uint64_t>(sources[e])*width };
+        #pragma omp simd
+        for (uint32_t k = 0; k < width; k++) acc[k] += source[k];
+      }
+    }
+
+    #pragma omp simd
+    for (uint32_t k = 0; k < width; k++) acc[k] *= step.damping;
+
+    // the teleportation vectors are sparse, so only the few that have an entry here add to it
+    for (auto s{ batch.offsets[i] }; s < batch.offsets[i + 1]; s++) {
+      const auto slot{ state.slots[batch.vectors[s]] };
+      if (slot >= 0) acc[slot] += state.coefficients[slot]*batch.weights[s];
+    }
+
+    const auto offset{ static_cast<uint64_t>(i)*width };
+    const auto* const old_ranks{ current.ranks + offset };
+    auto* const new_ranks{ next.ranks + offset };
+    auto* const new_scaled{ next.scaled + offset };
+    const auto inverse{ trans_matrix.is_weighted() ? 1.0 : degrees[i] == 0 ? 0.0 : 1.0/static_cast<double>(degrees[i]) };
+    const auto is_dangling{ degrees[i] == 0 };
+
+    #pragma omp simd
+    for (uint32_t k = 0; k < width; k++) {
+      const auto value{ acc[k] };
+      const auto diff{ value - old_ranks[k] };
+
+      new_ranks[k] = value;
+      new_scaled[k] = value*inverse;
+
+      sum[k] += step.norm == utility::Norm::L2 ? diff*diff : std::abs(diff);
+      peak[k] = std::max(peak[k], std::abs(diff));
+      dangling[k] += is_dangling ? value : 0.0;
+      mass[k] += value;
+    }
+  }
+}
+
+auto exe::pagerank_batch(
+  const Graph& trans_matrix,
+  const utility::Options& options,
+  const Batch& batch) -> BatchSolution {
+  const auto nodes{ trans_matrix.get_nodes() };
+  const auto vectors{ batch.size };
+  const auto blocks{ options.jobs };
+  const auto threads{ options.do_serial ? 1 : options.jobs };
+  const auto bounds{ trans_matrix.partition(blocks) };
+  const auto cells{ static_cast<uint64_t>(nodes)*vectors };
+
+  if (batch.offsets.size() != static_cast<size_t>(nodes) + 1)
+    throw Error{ std::string_view(__FILE__), ErrorCode::WRONG_DIMS_ERR };
+
+  // first touched by the threads that own their rows
+  std::unique_ptr<double[]> ranks[2]{
+    std::make_unique_for_overwrite<double[]>(cells), std::make_unique_for_overwrite<double[]>(cells) };
+  std::unique_ptr<double[]> scaled[2]{
+    std::make_unique_for_overwrite<double[]>(cells), std::make_unique_for_overwrite<double[]>(cells) };
+  std::vector<BatchPartial> partials(blocks, BatchPartial(vectors));
+  BatchPartial total(vectors);
+
+  BatchState state{};
+  state.active.resize(vectors);
+  state.slots.resize(vectors);
+  for (uint32_t k{ 0 }; k < vectors; k++) {
+    state.active[k] = k;
+    state.slots[k] = static_cast<int32_t>(k);
+  }
+  state.coefficients.resize(vectors);
+
+  const auto step{ make_step(trans_matrix, options, {}) };
+
+  BatchSolution solution{
+    .ranks = std::vector<double>(cells),
+    .iterations = std::vector<uint32_t>(vectors),
+    .residuals = std::vector<double>(vectors),
+  };
+  uint32_t iterations{ 0 };
+
+  auto& profiler{ utility::Profiler::get() };
+
+  // the sums of every block, in block order, for each of the first `width` columns
+  const auto combine_batch{ [&](const uint32_t width) {
+    for (uint32_t k{ 0 }; k < width; k++) {
+      total.sum[k] = total.peak[k] = total.dangling[k] = total.mass[k] = 0.0;
+      for (const auto& partial : partials) {
+        total.sum[k] += partial.sum[k];
+        total.peak[k] = std::max(total.peak[k], partial.peak[k]);
+        total.dangling[k] += partial.dangling[k];
+        total.mass[k] += partial.mass[k];
+      }
+      state.coefficients[k] = step.damping*total.dangling[k] + (1.0 - step.damping);
+    }
+  } };
+
+  #pragma omp parallel num_threads(threads)
+  {
+    // every thread always works on the same blocks, so a single thread
+    // goes through them in the same order as the parallel solvers
+    const auto thread{ static_cast<uint32_t>(omp_get_thread_num()) };
+    std::vector<double> row(vectors);
+
+    for (auto t{ thread }; t < blocks; t += threads) {
+      init_batch_rows(trans_matrix, batch, bounds[t], bounds[t + 1], { ranks[0].get(), scaled[0].get() }, state, partials[t]);
+    }
+
+    #pragma omp barrier
+
+    #pragma omp single
+    {
+      combine_batch(vectors);
+      profiler.begin_phase("iteration 0");
+    }
+
+    uint32_t current{ 0 };
+    while (!state.active.empty()) {
+      {
+        const utility::Profiler::ScopedSpan span("sweep");
+        for (auto t{ thread }; t < blocks; t += threads) {
+          sweep_batch_rows(
+            trans_matrix, batch,
+            bounds[t], bounds[t + 1],
+            { ranks[current].get(), scaled[current].get() },
+            { ranks[1 - current].get(), scaled[1 - current].get() },
+            state, step, row, partials[t]);
+        }
+      }
+      current = 1 - current;
+
+      #pragma omp barrier
+
+      #pragma omp single
+      {
+        const auto width{ static_cast<uint32_t>(state.active.size()) };
+        combine_batch(width);
+        iterations++;
+
+        // every vector that converged (or ran out of iterations) leaves the block
+        state.kept.clear();
+        state.done.clear();
+        for (uint32_t k{ 0 }; k < width; k++) {
+          const auto residual{ finish_residual(options.norm, {
+            .sum{ total.sum[k] }, .peak{ total.peak[k] }, .dangling{ 0.0 }, .mass{ 0.0 } }) };
+          const auto vector{ state.active[k] };
+
+          solution.residuals[vector] = residual;
+          solution.iterations[vector] = iterations;
+          if (residual < options.tolerance || iterations >= options.iterations) {
+            state.done.push_back(k);
+          } else {
+            state.kept.push_back(k);
+          }
+        }
+
+        profiler.end_phase();
+        if (!state.kept.empty()) profiler.begin_phase("iteration " + std::to_string(iterations));
+      }
+
+      if (!state.done.empty()) {
+        const auto width{ static_cast<uint64_t>(state.active.size()) };
+        const auto kept{ static_cast<uint64_t>(state.kept.size()) };
+
+        // the finished vectors are written out, and the rest are packed into the
+        // other buffer, which holds nothing anyone needs any more
+        for (auto t{ thread }; t < blocks; t += threads) {
+          for (uint64_t i{ bounds[t] }; i < bounds[t + 1]; i++) {
+            const auto* const from_ranks{ ranks[current].get() + i*width };
+            const auto* const from_scaled{ scaled[current].get() + i*width };
+            auto* const to_ranks{ ranks[1 - current].get() + i*kept };
+            auto* const to_scaled{ scaled[1 - current].get() + i*kept };
+
+            for (const auto k : state.done) {
+              solution.ranks[i*vectors + state.active[k]] = from_ranks[k]/total.mass[k];
+            }
+            for (uint64_t k{ 0 }; k < kept; k++) {
+              to_ranks[k] = from_ranks[state.kept[k]];
+              to_scaled[k] = from_scaled[state.kept[k]];
+            }
+          }
+        }
+        current = 1 - current;
+
+        #pragma omp barrier
+
+        #pragma omp single
+        {
+          for (const auto k : state.done) state.slots[state.active[k]] = -1;
+          for (uint32_t k{ 0 }; k < state.kept.size(); k++) {
+            const auto from{ state.kept[k] };
+            state.active[k] = state.active[from];
+            state.slots[state.active[k]] = static_cast<int32_t>(k);
+            state.coefficients[k] = state.coefficients[from];
+          }
+          state.active.resize(state.kept.size());
+        }
+      }
+    }
+  }
+
+  return solution;
+}
+
+auto exe::load_teleport(
+  const std::string_view path,
+  const uint32_t nodes) -> std::vector<double> {
+  return exe::load_teleport(path, nodes, 0, nodes);
+}
+
+auto exe::load_teleport(
+  const std::string_view path,
+  const uint32_t nodes,
+  const uint32_t first,
+  const uint32_t last) -> std::vector<double> {
+  const utility::MappedFile file(path);
+  const char* pos{ file.data() };
+  const char* const end{ file.data() + file.get_size() };
+
+  std::vector<double> teleport(last - first, 0.0);
+  double total{ 0.0 };
+
+  while (pos < end) {
+    const auto line_end{ std::find(pos, end, '\n') };
+    while (pos < line_end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) pos++;
+    if (pos == line_end || *pos == '#' || *pos == '%') {
+      pos = line_end + 1;
+      continue;
+    }
+
+    uint32_t node{ 0 };
+    double weight{ 1.0 };
+    const auto res{ std::from_chars(pos, line_end, node) };
+    if (res.ec != std::errc{} || node >= nodes) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+
+    pos = res.ptr;
+    while (pos < line_end && (*pos == ' ' || *pos == '\t')) pos++;
+    if (pos < line_end && *pos != '\r') {
+      const auto w_res{ std::from_chars(pos, line_end, weight) };
+      if (w_res.ec != std::errc{} || weight < 0.0) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+    }
+
+    if (node >= first && node < last) teleport[node - first] += weight;
+    total += weight;
+    pos = line_end + 1;
+  }
+
+  if (total <= 0.0) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+  for (auto& value : teleport) value /= total;
+
+  return teleport;
+}
+
+auto exe::load_batch(
+  const std::string_view path,
+  const uint32_t nodes) -> Batch {
+  const utility::MappedFile file(path);
+  const char* pos{ file.data() };
+  const char* const end{ file.data() + file.get_size() };
+
+  // every seed set, as (node, vector) pairs, before grouping them by node
+  std::vector<std::pair<uint32_t, uint32_t>> seeds{};
+  std::vector<uint32_t> sizes{};
+
+  while (pos < end) {
+    const auto line_end{ std::find(pos, end, '\n') };
+    while (pos < line_end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) pos++;
+    if (pos == line_end || *pos == '#' || *pos == '%') {
+      pos = line_end + 1;
+      continue;
+    }
+
+    const auto vector{ static_cast<uint32_t>(sizes.size()) };
+    sizes.push_back(0);
+    while (pos < line_end) {
+      uint32_t node{ 0 };
+      const auto res{ std::from_chars(pos, line_end, node) };
+      if (res.ec != std::errc{} || node >= nodes) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+
+      seeds.emplace_back(node, vector);
+      sizes[vector]++;
+      pos = res.ptr;
+      while (pos < line_end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) pos++;
+    }
+
+    pos = line_end + 1;
+  }
+
+  if (sizes.empty()) throw Error{ path, ErrorCode::BAD_FILE_ERR };
+
+  Batch batch{};
+  batch.size = static_cast<uint32_t>(sizes.size());
+  batch.offsets.assign(static_cast<size_t>(nodes) + 1, 0);
+  for (const auto& [node, vector] : seeds) batch.offsets[node + 1]++;
+  for (uint32_t i{ 0 }; i < nodes; i++) batch.offsets[i + 1] += batch.offsets[i];
+
+  batch.vectors.resize(seeds.size());
+  batch.weights.resize(seeds.size());
+  auto fill{ batch.offsets };
+  for (const auto& [node, vector] : seeds) {
+    const auto at{ fill[node]++ };
+    batch.vectors[at] = vector;
+    batch.weights[at] = 1.0/static_cast<double>(sizes[vector]);
+  }
+
+  return batch;
+}
@@ -0,0 +1,154 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SOLVER_HXX_
+#define _SOLVER_HXX_
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+#include "graph.hxx"
+#include "types.hxx"
+
+namespace exe {
+  /// What a PageRank solver produces
+  struct Solution {
+    /// Normalized to sum up to 1
+    std::vector<double> ranks{};
+    /// How many iterations the solver ran for
+    uint32_t            iterations{ 0 };
+    /// The norm of the difference between the last two iterates
+    double              residual{ 0.0 };
+    /// How many forward pushes ran before the sweeps
+    uint64_t            pushes{ 0 };
+    /// How many iterations gathered the ranks in reduced precision
+    uint32_t            reduced{ 0 };
+  };
+
+  /// Many teleportation vectors, stored by node, so that a sweep finds the
+  /// entries of its own rows right away. The entries of node `i` are
+  /// `[offsets[i], offsets[i + 1])` of `vectors` and `weights`
+  struct Batch {
+    std::vector<uint64_t> offsets{};
+    /// Which vector every entry belongs to
+    std::vector<uint32_t> vectors{};
+    std::vector<double>   weights{};
+    uint32_t              size{ 0 };
+  };
+
+  /// What the batched solver produces
+  struct BatchSolution {
+    /// One column per vector of the batch, stored by row (`nodes x size`).
+    /// Every column is normalized to sum up to 1
+    std::vector<double>   ranks{};
+    /// Per vector, how many iterations it took and its last residual
+    std::vector<uint32_t> iterations{};
+    std::vector<double>   residuals{};
+  };
+
+  /// Run PageRank on `trans_matrix`, with the damping factor `dump_fac`:
+  ///
+  ///   x' = d*(P*x + D(x)*v) + (1 - d)*v
+  ///
+  /// where `D(x)` is the rank of the nodes without outgoing links (which is
+  /// handed out the same way as teleportation) and `v` is the teleportation
+  /// vector, uniform when `teleport` is empty. The first iterate is `initial`,
+  /// which should sum up to 1, or `v` when that is empty.
+  ///
+  /// Both solvers split the rows in `jobs` blocks, and combine the per-block
+  /// sums in block order, so that they give bit for bit the same result for
+  /// the same `jobs`.
+  ///
+  /// With `Method::GAUSS_SEIDEL` and `Method::ASYNC` the ranks are updated in place,
+  /// and the rest of the sweep already reads them. The term of `D(x)` and the
+  /// teleportation come from the previous sweep. Gauss-Seidel only reads fresh ranks of
+  /// its own block, so it is deterministic; the asynchronous method reads whatever the
+  /// other threads last wrote. Both are splittings of the same system as the power
+  /// method and stop at the same tolerance, usually after fewer sweeps
+  auto pagerank_serial(
+    const utility::Graph& trans_matrix,
+    const utility::Options&,
+    const std::span<const double> teleport,
+    const std::span<const double> initial) -> Solution;
+
+  auto pagerank_parallel(
+    const utility::Graph& trans_matrix,
+    const utility::Options&,
+    const std::span<const double> teleport,
+    const std::span<const double> initial) -> Solution;
+
+  /// Refine `initial`, the ranks of a graph close to `trans_matrix`, forward-push style.
+  ///
+  /// One sweep finds the residual of every node, and then only the nodes whose residual
+  /// is above `tolerance/nodes` push it to their out-neighbors, until none is left or about
+  /// a sweep's worth of links has been touched. The regular solvers then finish the job,
+  /// so the result is checked against the same tolerance. Only the pushes are serial
+  auto pagerank_push(
+    const utility::Graph& trans_matrix,
+    const utility::Options&,
+    const std::span<const double> teleport,
+    const std::span<const double> initial) -> Solution;
+
+  /// Run PageRank for every vector of `batch` at once. The iterates of all vectors
+  /// form one row-major block, so that every link is read once per iteration for
+  /// all of them. Every vector stops on its own once it reaches the tolerance, and
+  /// is then dropped from the block.
+  ///
+  /// Runs on `jobs` threads, or a single one for `do_serial`, with the same result
+  auto pagerank_batch(
+    const utility::Graph& trans_matrix,
+    const utility::Options&,
+    const Batch& batch) -> BatchSolution;
+
+  /// Time `sweeps` power-method sweeps over `trans_matrix`, split the same way as the
+  /// solvers do, and return the fastest one in ms. Nothing else runs in between, so this
+  /// is what the graph itself costs, without the rest of an iteration
+  auto time_sweeps(
+    const utility::Graph& trans_matrix,
+    const utility::Options&,
+    const uint32_t sweeps) -> double;
+
+  /// Load a teleportation (personalization) vector for a graph with `nodes` nodes. Every
+  /// line of the file holds a `<node> [weight]` pair (the weight defaults to 1) and lines
+  /// starting with `#` are comments. The weights are normalized to sum up to 1
+  auto load_teleport(
+    const std::string_view path,
+    const uint32_t nodes) -> std::vector<double>;
+
+  /// Load the entries of nodes `[first, last)` only of the teleportation vector at `path`,
+  /// normalized by the weights of all nodes, the same as `load_teleport(path, nodes)` does
+  auto load_teleport(
+    const std::string_view path,
+    const uint32_t nodes,
+    const uint32_t first,
+    const uint32_t last) -> std::vector<double>;
+
+  /// Load a batch of teleportation vectors for a graph with `nodes` nodes. Every line
+  /// of the file is a seed set: the nodes (separated by whitespace) to teleport to,
+  /// all with the same weight. Lines starting with `#` are comments
+  auto load_batch(
+    const std::string_view path,
+    const uint32_t nodes) -> Batch;
+}
+
+#endif /* _SOLVER_HXX_ */
@@ -19,86 +19,275 @@
 
 #include "types.hxx"
 
+#include <algorithm>
+#include <cstddef>
 #include <string_view>
 
+#include <omp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define _PAGERANK_X86_
+#endif
+
 using namespace utility;
 
+// --- TYPES --- //
+
+/// The vectorized kernels all matrix operations are built on. Every
+/// kernel works on `count` contiguous elements
+struct Kernels {
+    std::string_view isa{};
+    /// `dst += src`
+    void (*add)(double* dst, const double* src, const size_t count){ nullptr };
+    /// `dst *= factor`
+    void (*scale)(double* dst, const double factor, const size_t count){ nullptr };
+    /// `dst += factor*src`
+    void (*axpy)(double* dst, const double* src, const double factor, const size_t count){ nullptr };
+};
+
+// --- CONSTANTS --- //
+
+/// Parallel operations split the storage in blocks that are multiples of
+/// this many elements, so that no two threads share a cache line
+constexpr size_t block_gc{ 8 };
+
+// --- FUNCTION DEFINITIONS --- //
+
+static auto add_scalar(
+    double* dst,
+    const double* src,
+    const size_t count) -> void {
+    for (size_t i{ 0 }; i < count; i++) dst[i] += src[i];
+}
+
+static auto scale_scalar(
+    double* dst,
+    const double factor,
+    const size_t count) -> void {
+    for (size_t i{ 0 }; i < count; i++) dst[i] *= factor;
+}
+
+static auto axpy_scalar(
+    double* dst,
+    const double* src,
+    const double factor,
+    const size_t count) -> void {
+    for (size_t i{ 0 }; i < count; i++) dst[i] += factor*src[i];
+}
+
+#ifdef _PAGERANK_X86_
+__attribute__((target("avx2,fma")))
+static auto add_avx2(
+    double* dst,
+    const double* src,
+    const size_t count) -> void {
+    size_t i{ 0 };
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+    }
+    add_scalar(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+static auto scale_avx2(
+    double* dst,
+    const double factor,
+    const size_t count) -> void {
+    const auto factors{ _mm256_set1_pd(factor) };
+    size_t i{ 0 };
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(dst + i), factors));
+    }
+    scale_scalar(dst + i, factor, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+static auto axpy_avx2(
+    double* dst,
+    const double* src,
+    const double factor,
+    const size_t count) -> void {
+    const auto factors{ _mm256_set1_pd(factor) };
+    size_t i{ 0 };
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(dst + i, _mm256_fmadd_pd(factors, _mm256_loadu_pd(src + i), _mm256_loadu_pd(dst + i)));
+    }
+    axpy_scalar(dst + i, src + i, factor, count - i);
+}
+
+__attribute__((target("avx512f")))
+static auto add_avx512(
+    double* dst,
+    const double* src,
+    const size_t count) -> void {
+    size_t i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(dst + i), _mm512_loadu_pd(src + i)));
+    }
+    add_scalar(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+static auto scale_avx512(
+    double* dst,
+    const double factor,
+    const size_t count) -> void {
+    const auto factors{ _mm512_set1_pd(factor) };
+    size_t i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(dst + i), factors));
+    }
+    scale_scalar(dst + i, factor, count - i);
+}
+
+__attribute__((target("avx512f")))
+static auto axpy_avx512(
+    double* dst,
+    const double* src,
+    const double factor,
+    const size_t count) -> void {
+    const auto factors{ _mm512_set1_pd(factor) };
+    size_t i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        _mm512_storeu_pd(dst + i, _mm512_fmadd_pd(factors, _mm512_loadu_pd(src + i), _mm512_loadu_pd(dst + i)));
+    }
+    axpy_scalar(dst + i, src + i, factor, count - i);
+}
+#endif
+
+/// Pick the widest kernels the CPU we are running on supports. This is
+/// only done once, the first time a matrix operation runs
+static auto get_kernels() -> const Kernels& {
+    static const Kernels kernels{ []() -> Kernels {
+#ifdef _PAGERANK_X86_
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return { "avx512", add_avx512, scale_avx512, axpy_avx512 };
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return { "avx2", add_avx2, scale_avx2, axpy_avx2 };
+#endif
+        return { "scalar", add_scalar, scale_scalar, axpy_scalar };
+    }() };
+
+    return kernels;
+}
+
+/// Run `operation(begin, end)` over `[0, count)`, split in one block per thread
+template<typename Operation>
+static auto for_blocks(
+    const size_t count,
+    const uint32_t threads,
+    const Operation& operation) -> void {
+    #pragma omp parallel num_threads(threads)
+    {
+        const auto thread{ static_cast<size_t>(omp_get_thread_num()) };
+        const auto team{ static_cast<size_t>(omp_get_num_threads()) };
+        const auto blocks{ (count + block_gc - 1)/block_gc };
+
+        const auto begin{ std::min(count, blocks*thread/team*block_gc) };
+        const auto end{ std::min(count, blocks*(thread + 1)/team*block_gc) };
+        if (begin < end) operation(begin, end);
+    }
+}
+
 Matrix::Matrix(
     uint32_t x,
     uint32_t y)
-    : data(x*y)
+    : data(static_cast<size_t>(x)*y)
     , dims{x, y} {}
 
-inline auto Matrix::operator()(
-    const uint32_t x,
-    const uint32_t y) -> double& {
-    if (x >= dims[0] || y >= dims[1])
-        throw Error{ std::string_view(__FILE__), Error::ErrorCode::OUT_OF_BOUNDS_ERR };
+auto Matrix::get_isa() -> std::string_view {
+    return get_kernels().isa;
+}
+
+auto Matrix::operator=(Matrix& right) -> Matrix& {
+    return this->copy_paral(right, 1);
+}
+
+auto Matrix::operator+=(Matrix& right) -> Matrix& {
+    return this->add_paral(right, 1);
+}
 
-    return this->data[x + dims[0]*y];
+auto Matrix::operator*(const double factor) -> Matrix& {
+    return this->mul_paral(factor, 1);
 }
 
-template<uint32_t dim>
-inline auto Matrix::get_dimension() const -> uint32_t {
-    if constexpr (dim == 0)
-        return this->dims[0];
-    else if constexpr (dim == 1)
-        return this->dims[1];
+auto Matrix::operator*(Matrix& right) -> Matrix {
+    return this->mul_paral(right, 1);
 }
 
-auto Matrix::operator=(Matrix& right) -> Matrix& {
+auto Matrix::copy_paral(
+    Matrix& right,
+    const uint32_t threads) -> Matrix& {
     if (this->get_dimension<0>() != right.get_dimension<0>()
-        && this->get_dimension<1>() != right.get_dimension<1>())
+        || this->get_dimension<1>() != right.get_dimension<1>())
         throw Error{ std::string_view(__FILE__), Error::ErrorCode::WRONG_DIMS_ERR };
 
-    for (uint32_t i{0}; i < this->get_dimension<0>(); i++) {
-        for (uint32_t j{0}; j < this->get_dimension<1>(); j++) {
-            (*this)(i, j) = right(i, j);
-        }
-    }
+    for_blocks(this->data.size(), threads, [&](const size_t begin, const size_t end) {
+        std::copy(right.data.begin() + begin, right.data.begin() + end, this->data.begin() + begin);
+    });
 
     return (*this);
 }
 
-auto Matrix::operator+=(Matrix& right) -> Matrix& {
+auto Matrix::add_paral(
+    Matrix& right,
+    const uint32_t threads) -> Matrix& {
     if (this->get_dimension<0>() != right.get_dimension<0>()
-        && this->get_dimension<1>() != right.get_dimension<1>())
-        throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+        || this->get_dimension<1>() != right.get_dimension<1>())
+        throw Error{ std::string_view(__FILE__), Error::ErrorCode::WRONG_DIMS_ERR };
 
-    for (uint32_t i{0}; i < this->get_dimension<0>(); i++) {
-        for (uint32_t j{0}; j < this->get_dimension<1>(); j++) {
-            (*this)(i, j) = (*this)(i, j) + right(i, j);
-        }
-    }
+    const auto& kernels{ get_kernels() };
+    for_blocks(this->data.size(), threads, [&](const size_t begin, const size_t end) {
+        kernels.add(this->data.data() + begin, right.data.data() + begin, end - begin);
+    });
 
     return *this;
 }
 
-auto Matrix::operator*(const double factor) -> Matrix& {
-    for (uint32_t i{ 0 }; i < this->get_dimension<0>(); i++) {
-        for (uint32_t j{ 0 }; j < this->get_dimension<1>(); j++) {
-            (*this)(i, j) *= factor;
-        }
-    }
+auto Matrix::mul_paral(
+    const double factor,
+    const uint32_t threads) -> Matrix& {
+    const auto& kernels{ get_kernels() };
+    for_blocks(this->data.size(), threads, [&](const size_t begin, const size_t end) {
+        kernels.scale(this->data.data() + begin, factor, end - begin);
+    });
 
     return (*this);
 }
 
-auto Matrix::operator*(Matrix& right) -> Matrix {
+auto Matrix::mul_paral(
+    Matrix& right,
+    const uint32_t threads) -> Matrix {
     if (this->get_dimension<1>() != right.get_dimension<0>())
-        throw Error{ "", Error::ErrorCode::WRONG_DIMS_ERR };
+        throw Error{ std::string_view(__FILE__), Error::ErrorCode::WRONG_DIMS_ERR };
+
+    const size_t rows{ this->get_dimension<0>() };
+    const size_t inner{ this->get_dimension<1>() };
+    const size_t columns{ right.get_dimension<1>() };
 
     Matrix result(
         this->get_dimension<0>(),
         right.get_dimension<1>());
-    for (uint32_t i{0}; i < this->get_dimension<0>(); i++) {
-        for (uint32_t j{0}; j < right.get_dimension<1>(); j++) {
-            for (uint32_t k{0}; k < this->get_dimension<1>(); k++) {
-                result(i, j) += (*this)(i, k)*right(k, j);
+
+    // the storage is column-major, so column j of the result is the sum of the
+    // columns of the left matrix, scaled by column j of the right one. Every
+    // thread works on its own block of rows, which keeps all accesses contiguous
+    const auto& kernels{ get_kernels() };
+    for_blocks(rows, threads, [&](const size_t begin, const size_t end) {
+        for (size_t j{ 0 }; j < columns; j++) {
+            auto* const result_col{ result.data.data() + rows*j + begin };
+
+            for (size_t k{ 0 }; k < inner; k++) {
+                kernels.axpy(
+                    result_col,
+                    this->data.data() + rows*k + begin,
+                    right.data[k + inner*j],
+                    end - begin);
             }
         }
-    }
+    });
 
     return result;
 }
-
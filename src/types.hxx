@@ -20,6 +20,7 @@
 #ifndef _TYPES_HXX_
 #define _TYPES_HXX_
 
+#include <array>
 #include <cstdint>
 #include <string_view>
 #include <vector>
@@ -29,15 +30,121 @@
 // --- TYPES --- //
 
 namespace utility {
+  /// The norm to measure the residual between two iterates with
+  enum class Norm : int {
+    L1 = 0,
+    L2 = 1,
+    LINF = 2,
+  };
+
+  /// The random graph models `generate` knows of
+  enum class Model : int {
+    ER = 0,
+    RMAT = 1,
+    BA = 2,
+  };
+
+  /// How a solver updates the ranks
+  enum class Method : int {
+    /// Jacobi, every sweep reads only the previous iterate
+    POWER = 0,
+    /// In place within every block of rows, deterministic
+    GAUSS_SEIDEL = 1,
+    /// In place over the whole vector, threads read whatever their neighbors wrote last
+    ASYNC = 2,
+  };
+
+  /// How to relabel the nodes of a graph before solving, so that the ranks a sweep gathers lie closer together
+  enum class Reorder : int {
+    NONE = 0,
+    /// By decreasing out-degree, so that the ranks read the most share cache lines
+    DEGREE = 1,
+    /// Reverse Cuthill-McKee, which keeps the links of every row within a narrow band
+    RCM = 2,
+    /// Community by community, so that the links within one land close together
+    RABBIT = 3,
+  };
+
+  /// What the power method keeps the ranks it gathers over every link in
+  enum class Precision : int {
+    DOUBLE = 0,
+    /// Single precision, until the residual gets down to its rounding
+    FLOAT = 1,
+    /// bfloat16, until the residual gets down to its rounding
+    BF16 = 2,
+  };
+
+  /// How to pin threads to CPUs
+  enum class Bind : int {
+    NONE = 0,
+    /// Fill up the CPUs of a node before moving on to the next one
+    COMPACT = 1,
+    /// Deal the threads out to the nodes in turn
+    SPREAD = 2,
+  };
+
   struct Options {
     void*            command_p{ nullptr };
     std::string_view appname{};
     //
     bool             do_serial{ true };
     uint32_t         jobs{ 1 };
+    Bind             bind{ Bind::NONE };
     uint32_t         dims[2]{ 2, 2 };
     double           dump_fac{ 0.5 };
     uint32_t         iterations{ 1 };
+    /// Stop as soon as the residual drops below this. 0 runs all `iterations`
+    double           tolerance{ 0.0 };
+    Norm             norm{ Norm::L1 };
+    Method           method{ Method::POWER };
+    /// How many source nodes every segment of a blocked sweep spans. 0 sweeps whole rows
+    uint32_t         block_nodes{ 0 };
+    /// Size the segments after the last level cache, which sets `block_nodes` once the graph is there
+    bool             block_auto{ false };
+    Reorder          reorder{ Reorder::NONE };
+    Precision        precision{ Precision::DOUBLE };
+    std::string_view graph_path{};
+    /// The teleportation (personalization) vector. Uniform when empty
+    std::string_view personalize_path{};
+    /// Many teleportation vectors, solved for together. Takes precedence over `personalize_path`
+    std::string_view batch_path{};
+    std::string_view binary_path{};
+    // incremental updates
+    /// Links to add to and remove from the graph before solving
+    std::string_view delta_path{};
+    /// A rank file to start from
+    std::string_view warm_path{};
+    /// Where to write the final ranks as a rank file
+    std::string_view ranks_path{};
+    // output
+    /// Where to write the ranks instead of the standard output. `.f64` and `.f32` files get them as raw binary
+    std::string_view output_path{};
+    /// Only write the ranks of this many nodes, the highest ones. 0 writes them all
+    uint32_t         top_k{ 0 };
+    /// Refine the warm start with forward pushes before sweeping
+    bool             push{ false };
+    /// Split the rows over the processes of an MPI job, with `jobs` threads in every one
+    bool             distributed{ false };
+    // checkpoints
+    std::string_view checkpoint_path{};
+    uint32_t         checkpoint_every{ 10 };
+    /// A checkpoint to carry on from
+    std::string_view resume_path{};
+    // graph generation
+    Model            model{ Model::ER };
+    uint64_t         seed{ 0 };
+    /// The average amount of outgoing links of every node
+    uint32_t         degree{ 16 };
+    // profiling
+    bool             profile{ false };
+    std::string_view trace_path{};
+    // benchmarking
+    uint32_t         tries{ 1 };
+    std::string_view save_path{};
+    /// Every value given to `--jobs` and `--dims`. The first one of
+    /// each is also stored in `jobs` and `dims`
+    std::vector<uint32_t>                sweep_jobs{};
+    std::vector<std::array<uint32_t, 2>> sweep_dims{};
   };
 
   struct Error {
@@ -50,6 +157,13 @@ namespace utility {
       BAD_DUMPING_FAC_ERR = 5,
       OUT_OF_BOUNDS_ERR = 6,
       WRONG_DIMS_ERR = 7,
+      FILE_ERR = 8,
+      BAD_FILE_ERR = 9,
+      WEIGHTED_ERR = 10,
+      MISSING_LINK_ERR = 11,
+      NO_MPI_ERR = 12,
+      DISTRIBUTED_ERR = 13,
+      MPI_THREAD_ERR = 14,
     };
     // --- FIELDS --- //
     std::string_view erroneous{};
@@ -71,19 +185,35 @@ namespace utility {
       /// Access the element at (x, y)
       inline auto operator()(
         const uint32_t x,
-        const uint32_t y) -> double&;
+        const uint32_t y) -> double& {
+        if (x >= dims[0] || y >= dims[1])
+          throw Error{ std::string_view(__FILE__), Error::ErrorCode::OUT_OF_BOUNDS_ERR };
+
+        return this->data[x + dims[0]*y];
+      }
 
       template<uint32_t dim>
-      inline auto get_dimension() const -> uint32_t;
+      inline auto get_dimension() const -> uint32_t {
+        if constexpr (dim == 0)
+          return this->dims[0];
+        else if constexpr (dim == 1)
+          return this->dims[1];
+      }
+
+      /// The instruction set the matrix operations were dispatched to
+      /// on this machine (`avx512`, `avx2` or `scalar`)
+      static auto get_isa() -> std::string_view;
 
-      // Serial matrix operations
+      // Serial matrix operations. These work on the whole storage at once
+      // with the vectorized kernels, without checking every element access
 
       auto operator=(Matrix&) -> Matrix&;
       auto operator+=(Matrix&) -> Matrix&;
       auto operator*(const double factor) -> Matrix&;
       auto operator*(Matrix&) -> Matrix;
 
-      // Parallel matrix operations
+      // Parallel matrix operations. The same kernels as the serial
+      // ones, with the storage split in blocks over `threads` threads
 
       auto copy_paral(
         Matrix&,
@@ -100,4 +230,19 @@ namespace utility {
   };
 }
 
+// --- CONSTANTS --- //
+
+namespace utility {
+  /// How to print every `Model`
+  inline constexpr const char* model_names_gc[]{ "Erdos-Renyi", "R-MAT", "Barabasi-Albert" };
+  /// How to print every `Norm`
+  inline constexpr const char* norm_names_gc[]{ "L1", "L2", "Linf" };
+  /// How to print every `Method`
+  inline constexpr const char* method_names_gc[]{ "power", "Gauss-Seidel", "asynchronous" };
+  /// How to print every `Precision`
+  inline constexpr const char* precision_names_gc[]{ "double", "float", "bfloat16" };
+  /// How to print every `Reorder`
+  inline constexpr const char* reorder_names_gc[]{ "none", "degree", "RCM", "Rabbit (label propagation)" };
+}
+
 #endif /* _TYPES_HXX */
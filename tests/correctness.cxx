@@ -0,0 +1,625 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Checks every solver and every mode of them against a plain reference solver on small graphs,
+// and that the modes that promise the same bits for any thread count keep that promise.
+//
+// Run with the name of a test to run only that one, or with none to run all of them
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generate.hxx"
+#include "graph.hxx"
+#include "library.hxx"
+#include "reorder.hxx"
+#include "solver.hxx"
+#include "types.hxx"
+
+using Graph = utility::Graph;
+
+// --- TYPES --- //
+
+/// A small graph, along with the links it was built out of for the reference solver
+struct Case {
+  std::string                      name{};
+  uint32_t                         nodes{ 0 };
+  std::vector<utility::EdgeList>   links{};
+  Graph                            graph{};
+};
+
+struct Test {
+  const char* name{ "" };
+  /// How many checks failed
+  uint32_t (*run)(){ nullptr };
+};
+
+// --- CONSTANTS --- //
+
+constexpr double damping_gc{ 0.85 };
+/// What the solvers run to
+constexpr double tolerance_gc{ 1e-13 };
+/// How far a solution may be from the reference, in L1
+constexpr double accuracy_gc{ 1e-9 };
+constexpr uint32_t max_iterations_gc{ 10000 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+static auto make_cases() -> std::vector<Case>;
+static auto make_options(const uint32_t jobs) -> utility::Options;
+/// A teleportation vector that favors every third node
+static auto make_teleport(const uint32_t nodes) -> std::vector<double>;
+
+/// Plain power iterations over the links themselves, run until they stop changing
+static auto reference(
+  const Case&,
+  const std::span<const double> teleport) -> std::vector<double>;
+
+static auto distance(
+  const std::span<const double> left,
+  const std::span<const double> right) -> double;
+/// Count a failure, and say what it was, unless `passed`
+static auto check(
+  const bool passed,
+  const std::string& what) -> uint32_t;
+/// Check `ranks` against the reference of `test`
+static auto check_close(
+  const std::span<const double> ranks,
+  const std::span<const double> expected,
+  const std::string& what) -> uint32_t;
+static auto check_same(
+  const std::span<const double> left,
+  const std::span<const double> right,
+  const std::string& what) -> uint32_t;
+
+static auto test_matrix() -> uint32_t;
+static auto test_analytic() -> uint32_t;
+static auto test_serial() -> uint32_t;
+static auto test_parallel() -> uint32_t;
+static auto test_methods() -> uint32_t;
+static auto test_precision() -> uint32_t;
+static auto test_blocking() -> uint32_t;
+static auto test_reorder() -> uint32_t;
+static auto test_batch() -> uint32_t;
+static auto test_push() -> uint32_t;
+static auto test_library() -> uint32_t;
+static auto test_determinism() -> uint32_t;
+
+constexpr Test tests_gc[]{
+  { "matrix", test_matrix },
+  { "analytic", test_analytic },
+  { "serial", test_serial },
+  { "parallel", test_parallel },
+  { "methods", test_methods },
+  { "precision", test_precision },
+  { "blocking", test_blocking },
+  { "reorder", test_reorder },
+  { "batch", test_batch },
+  { "push", test_push },
+  { "library", test_library },
+  { "determinism", test_determinism },
+};
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto main(int argc, char** argv) -> int {
+  const std::string_view only{ argc > 1 ? argv[1] : "" };
+
+  uint32_t failures{ 0 };
+  bool found{ false };
+  for (const auto& test : tests_gc) {
+    if (!only.empty() && only != test.name) continue;
+
+    found = true;
+    try {
+      const auto failed{ test.run() };
+      std::cout << (failed == 0 ? "PASS " : "FAIL ") << test.name << "\n";
+      failures += failed;
+    } catch (const utility::Error& err) {
+      std::cout << "FAIL " << test.name << ": threw error " << static_cast<int>(err.error)
+                << " (" << err.erroneous << ")\n";
+      failures++;
+    }
+  }
+
+  if (!found) {
+    std::cerr << "No test is called " << only << "\n";
+    return 2;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
+
+static auto make_cases() -> std::vector<Case> {
+  const auto edges{ [](const std::vector<utility::Edge>& links) {
+    return std::vector<utility::EdgeList>{ { links, {} } };
+  } };
+
+  std::vector<Case> cases{};
+  cases.push_back({ "cycle", 3, edges({ { 0, 1 }, { 1, 2 }, { 2, 0 } }) });
+  // 2 and 4 have no outgoing links, and 4 no incoming ones either
+  cases.push_back({ "dangling", 5, edges({ { 0, 1 }, { 0, 2 }, { 1, 2 }, { 3, 2 }, { 3, 0 } }) });
+  // a self-loop and a link that is there twice
+  cases.push_back({ "multi", 3, edges({ { 0, 0 }, { 0, 1 }, { 0, 1 }, { 1, 2 }, { 2, 0 }, { 2, 1 } }) });
+  // 1 only has a link of weight 0, so it spreads its rank evenly, and 3 has no links at all
+  cases.push_back({ "weighted", 4, { {
+    { { 0, 1 }, { 0, 2 }, { 1, 2 }, { 2, 0 }, { 2, 3 } },
+    { 2.0, 1.0, 0.0, 3.0, 1.0 } } } });
+  cases.push_back({ "er", 300, utility::generate_links(utility::Model::ER, 300, 3, 11, 2) });
+  cases.push_back({ "rmat", 512, utility::generate_links(utility::Model::RMAT, 512, 4, 3, 2) });
+  cases.push_back({ "ba", 257, utility::generate_links(utility::Model::BA, 257, 2, 5, 2) });
+
+  for (auto& test : cases) test.graph = Graph::from_edges(test.links, test.nodes, 2);
+  return cases;
+}
+
+static auto make_options(const uint32_t jobs) -> utility::Options {
+  utility::Options options{};
+  options.jobs = jobs;
+  options.dump_fac = damping_gc;
+  options.iterations = max_iterations_gc;
+  options.tolerance = tolerance_gc;
+  return options;
+}
+
+static auto make_teleport(const uint32_t nodes) -> std::vector<double> {
+  std::vector<double> teleport(nodes);
+  for (uint32_t i{ 0 }; i < nodes; i++) teleport[i] = i % 3 == 0 ? 3.0 : 1.0;
+
+  double total{ 0.0 };
+  for (const auto value : teleport) total += value;
+  for (auto& value : teleport) value /= total;
+  return teleport;
+}
+
+static auto reference(
+  const Case& test,
+  const std::span<const double> teleport) -> std::vector<double> {
+  const auto nodes{ test.nodes };
+  const auto uniform{ 1.0/static_cast<double>(nodes) };
+  const auto teleport_of{ [&](const uint32_t i) { return teleport.empty() ? uniform : teleport[i]; } };
+
+  std::vector<uint32_t> degrees(nodes);
+  std::vector<double> weights(nodes);
+  for (const auto& part : test.links) {
+    for (uint64_t e{ 0 }; e < part.edges.size(); e++) {
+      degrees[part.edges[e].from]++;
+      if (!part.weights.empty()) weights[part.edges[e].from] += part.weights[e];
+    }
+  }
+
+  std::vector<double> ranks(nodes);
+  for (uint32_t i{ 0 }; i < nodes; i++) ranks[i] = teleport_of(i);
+
+  for (uint32_t iteration{ 0 }; iteration < 100*max_iterations_gc; iteration++) {
+    double dangling{ 0.0 };
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+      if (degrees[i] == 0) dangling += ranks[i];
+    }
+
+    std::vector<double> next(nodes);
+    for (const auto& part : test.links) {
+      for (uint64_t e{ 0 }; e < part.edges.size(); e++) {
+        const auto [from, to]{ part.edges[e] };
+        const auto share{ part.weights.empty() || weights[from] == 0.0
+          ? 1.0/static_cast<double>(degrees[from])
+          : part.weights[e]/weights[from] };
+        next[to] += share*ranks[from];
+      }
+    }
+    for (uint32_t i{ 0 }; i < nodes; i++) {
+      next[i] = damping_gc*(next[i] + dangling*teleport_of(i)) + (1.0 - damping_gc)*teleport_of(i);
+    }
+
+    const auto change{ distance(ranks, next) };
+    ranks = std::move(next);
+    if (change < 1e-15) break;
+  }
+
+  double total{ 0.0 };
+  for (const auto rank : ranks) total += rank;
+  for (auto& rank : ranks) rank /= total;
+  return ranks;
+}
+
+static auto distance(
+  const std::span<const double> left,
+  const std::span<const double> right) -> double {
+  if (left.size() != right.size()) return INFINITY;
+
+  double total{ 0.0 };
+  for (size_t i{ 0 }; i < left.size(); i++) total += std::abs(left[i] - right[i]);
+  return total;
+}
+
+static auto check(
+  const bool passed,
+  const std::string& what) -> uint32_t {
+  if (passed) return 0;
+
+  std::cout << "  failed: " << what << "\n";
+  return 1;
+}
+
+static auto check_close(
+  const std::span<const double> ranks,
+  const std::span<const double> expected,
+  const std::string& what) -> uint32_t {
+  const auto off{ distance(ranks, expected) };
+  return check(off < accuracy_gc, what + " is " + std::to_string(off) + " off the reference");
+}
+
+static auto check_same(
+  const std::span<const double> left,
+  const std::span<const double> right,
+  const std::string& what) -> uint32_t {
+  return check(
+    left.size() == right.size() && std::memcmp(left.data(), right.data(), left.size_bytes()) == 0,
+    what + " differ in their bits");
+}
+
+static auto test_matrix() -> uint32_t {
+  uint32_t failed{ 0 };
+
+  // sizes that leave a tail past every vector width
+  for (const auto [rows, columns] : { std::array<uint32_t, 2>{ 1, 1 }, { 7, 5 }, { 33, 17 }, { 64, 64 } }) {
+    const auto name{ std::to_string(rows) + "x" + std::to_string(columns) + " " };
+    utility::Matrix left(rows, columns);
+    utility::Matrix right(rows, columns);
+    utility::Matrix square(columns, rows);
+    for (uint32_t x{ 0 }; x < rows; x++) {
+      for (uint32_t y{ 0 }; y < columns; y++) {
+        left(x, y) = 0.5*x - 0.25*y;
+        right(x, y) = 1.0 + x*y % 7;
+        square(y, x) = (x + 2.0*y) / 8.0;
+      }
+    }
+
+    utility::Matrix sum(rows, columns);
+    sum = left;
+    sum += right;
+    utility::Matrix sum_paral(rows, columns);
+    sum_paral.copy_paral(left, 3);
+    sum_paral.add_paral(right, 3);
+
+    utility::Matrix scaled(rows, columns);
+    scaled = left;
+    scaled * 3.0;
+    utility::Matrix scaled_paral(rows, columns);
+    scaled_paral.copy_paral(left, 3);
+    scaled_paral.mul_paral(3.0, 3);
+
+    auto product{ left*square };
+    auto product_paral{ left.mul_paral(square, 3) };
+
+    bool exact{ true };
+    for (uint32_t x{ 0 }; x < rows; x++) {
+      for (uint32_t y{ 0 }; y < columns; y++) {
+        exact &= sum(x, y) == left(x, y) + right(x, y) && sum_paral(x, y) == sum(x, y);
+        exact &= scaled(x, y) == 3.0*left(x, y) && scaled_paral(x, y) == scaled(x, y);
+      }
+    }
+    failed += check(exact, name + "sums and scalings");
+
+    double off{ 0.0 };
+    for (uint32_t x{ 0 }; x < rows; x++) {
+      for (uint32_t y{ 0 }; y < rows; y++) {
+        double expected{ 0.0 };
+        for (uint32_t k{ 0 }; k < columns; k++) expected += left(x, k)*square(k, y);
+        off = std::max(off, std::abs(product(x, y) - expected));
+        failed += check(product_paral(x, y) == product(x, y), name + "serial and parallel products");
+      }
+    }
+    failed += check(off < 1e-9, name + "product");
+  }
+
+  utility::Matrix small(2, 3);
+  utility::Matrix large(3, 3);
+  bool threw{ false };
+  try {
+    small += large;
+  } catch (const utility::Error& err) {
+    threw = err.error == utility::Error::ErrorCode::WRONG_DIMS_ERR;
+  }
+  failed += check(threw, "adding matrices of different dimensions");
+
+  return failed;
+}
+
+static auto test_analytic() -> uint32_t {
+  const auto cases{ make_cases() };
+  uint32_t failed{ 0 };
+
+  // on a cycle, every node passes all of its rank on, so the ranks stay uniform
+  const auto cycle{ exe::pagerank_serial(cases[0].graph, make_options(1), {}, {}) };
+  for (const auto rank : cycle.ranks) failed += check(std::abs(rank - 1.0/3.0) < 1e-15, "cycle rank");
+
+  // 4 has no incoming links, so it only ever gets the teleportation and the dangling rank,
+  // which both go to every node the same
+  const auto dangling{ exe::pagerank_serial(cases[1].graph, make_options(1), {}, {}) };
+  const auto& ranks{ dangling.ranks };
+  const auto dangling_share{ damping_gc*(ranks[2] + ranks[4]) + (1.0 - damping_gc) };
+  failed += check(std::abs(ranks[4] - dangling_share/5.0) < 1e-12, "dangling rank of an unlinked node");
+  failed += check(std::abs(ranks[3] - ranks[4]) < 1e-15, "ranks of the unlinked nodes");
+
+  return failed;
+}
+
+static auto test_serial() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto teleport{ make_teleport(test.nodes) };
+    for (const auto jobs : { 1u, 3u }) {
+      const auto name{ test.name + " serial, " + std::to_string(jobs) + " jobs" };
+      failed += check_close(exe::pagerank_serial(test.graph, make_options(jobs), {}, {}).ranks, reference(test, {}), name);
+      failed += check_close(
+        exe::pagerank_serial(test.graph, make_options(jobs), teleport, {}).ranks,
+        reference(test, teleport),
+        name + ", personalized");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_parallel() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto teleport{ make_teleport(test.nodes) };
+    for (const auto jobs : { 1u, 4u }) {
+      const auto name{ test.name + " parallel, " + std::to_string(jobs) + " jobs" };
+      failed += check_close(exe::pagerank_parallel(test.graph, make_options(jobs), {}, {}).ranks, reference(test, {}), name);
+      failed += check_close(
+        exe::pagerank_parallel(test.graph, make_options(jobs), teleport, {}).ranks,
+        reference(test, teleport),
+        name + ", personalized");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_methods() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto expected{ reference(test, {}) };
+    for (const auto method : { utility::Method::GAUSS_SEIDEL, utility::Method::ASYNC }) {
+      auto options{ make_options(3) };
+      options.method = method;
+
+      const auto name{ test.name + (method == utility::Method::ASYNC ? " async" : " Gauss-Seidel") };
+      failed += check_close(exe::pagerank_serial(test.graph, options, {}, {}).ranks, expected, name + " serial");
+      failed += check_close(exe::pagerank_parallel(test.graph, options, {}, {}).ranks, expected, name + " parallel");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_precision() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto expected{ reference(test, {}) };
+    for (const auto precision : { utility::Precision::FLOAT, utility::Precision::BF16 }) {
+      auto options{ make_options(2) };
+      options.precision = precision;
+
+      const auto name{ test.name + (precision == utility::Precision::FLOAT ? " float" : " bfloat16") };
+      failed += check_close(exe::pagerank_serial(test.graph, options, {}, {}).ranks, expected, name + " serial");
+      failed += check_close(exe::pagerank_parallel(test.graph, options, {}, {}).ranks, expected, name + " parallel");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_blocking() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto plain{ exe::pagerank_serial(test.graph, make_options(2), {}, {}) };
+    for (const auto width : { 1u, 7u, 64u }) {
+      auto options{ make_options(2) };
+      options.block_nodes = width;
+
+      const auto name{ test.name + " blocked by " + std::to_string(width) };
+      const auto serial{ exe::pagerank_serial(test.graph, options, {}, {}) };
+      failed += check_close(serial.ranks, reference(test, {}), name);
+      // the segments only change which links are summed up when, not in which order every row sums them
+      failed += check_same(serial.ranks, plain.ranks, name + " and unblocked ranks");
+      failed += check_same(exe::pagerank_parallel(test.graph, options, {}, {}).ranks, serial.ranks, name + " serial and parallel ranks");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_reorder() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    const auto teleport{ make_teleport(test.nodes) };
+    const auto expected{ reference(test, teleport) };
+    for (const auto how : { utility::Reorder::DEGREE, utility::Reorder::RCM, utility::Reorder::RABBIT }) {
+      const auto order{ utility::reorder(test.graph, how, 2) };
+      const auto permuted{ test.graph.permute(order, 2) };
+      const auto moved{ utility::permute_rows(teleport, order, 1, 2) };
+
+      const auto solution{ exe::pagerank_parallel(permuted, make_options(2), moved, {}) };
+      failed += check_close(
+        utility::restore_rows(solution.ranks, order, 1, 2),
+        expected,
+        test.name + " reordered " + std::to_string(static_cast<int>(how)));
+      failed += check(utility::reorder(test.graph, how, 1) == order, test.name + " orders on 1 and 2 threads");
+    }
+  }
+
+  return failed;
+}
+
+static auto test_batch() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    // one vector teleports to nodes 0 and 1, the other to the last node only
+    const std::vector<std::vector<uint32_t>> seeds{ { 0, 1 }, { test.nodes - 1 } };
+
+    exe::Batch batch{};
+    batch.size = static_cast<uint32_t>(seeds.size());
+    batch.offsets.assign(test.nodes + 1, 0);
+    for (uint32_t i{ 0 }; i < test.nodes; i++) {
+      for (uint32_t k{ 0 }; k < batch.size; k++) {
+        if (std::find(seeds[k].begin(), seeds[k].end(), i) == seeds[k].end()) continue;
+        batch.vectors.push_back(k);
+        batch.weights.push_back(1.0/static_cast<double>(seeds[k].size()));
+      }
+      batch.offsets[i + 1] = batch.vectors.size();
+    }
+
+    auto options{ make_options(3) };
+    const auto parallel{ exe::pagerank_batch(test.graph, options, batch) };
+    options.do_serial = true;
+    const auto serial{ exe::pagerank_batch(test.graph, options, batch) };
+    failed += check_same(serial.ranks, parallel.ranks, test.name + " serial and parallel batches");
+
+    for (uint32_t k{ 0 }; k < batch.size; k++) {
+      std::vector<double> teleport(test.nodes);
+      for (const auto seed : seeds[k]) teleport[seed] = 1.0/static_cast<double>(seeds[k].size());
+
+      std::vector<double> column(test.nodes);
+      for (uint32_t i{ 0 }; i < test.nodes; i++) column[i] = parallel.ranks[i*batch.size + k];
+      failed += check_close(column, reference(test, teleport), test.name + " batch vector " + std::to_string(k));
+    }
+  }
+
+  return failed;
+}
+
+static auto test_push() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    // a rough start, as a graph that changed a little would give
+    auto rough{ make_options(2) };
+    rough.iterations = 3;
+    rough.tolerance = 0.0;
+    const auto start{ exe::pagerank_serial(test.graph, rough, {}, {}) };
+
+    const auto solution{ exe::pagerank_push(test.graph, make_options(2), {}, start.ranks) };
+    failed += check_close(solution.ranks, reference(test, {}), test.name + " forward push");
+    // and a warm start on its own
+    failed += check_close(
+      exe::pagerank_parallel(test.graph, make_options(2), {}, start.ranks).ranks,
+      reference(test, {}),
+      test.name + " warm start");
+  }
+
+  return failed;
+}
+
+static auto test_library() -> uint32_t {
+  uint32_t failed{ 0 };
+  pagerank::Pool single{ 1 };
+  pagerank::Pool team{ 4 };
+  pagerank::Solver alone{ single, 3 };
+  pagerank::Solver together{ team, 3 };
+
+  for (const auto& test : make_cases()) {
+    const auto graph{ pagerank::Graph::from_csr(
+      team, test.graph.offsets(), test.graph.sources(), test.graph.weights(), {}) };
+    const auto teleport{ make_teleport(test.nodes) };
+    const pagerank::Request request{
+      .damping{ damping_gc }, .iterations{ max_iterations_gc }, .tolerance{ tolerance_gc }, .teleport{ teleport } };
+
+    // the ranks live in the solvers, so they are copied before solving again
+    const auto first{ alone.solve(graph, request) };
+    const std::vector<double> ranks(first.ranks.begin(), first.ranks.end());
+    failed += check(first.status == pagerank::Status::CONVERGED, test.name + " library solve converging");
+    failed += check_close(ranks, reference(test, teleport), test.name + " library solve");
+    failed += check_same(together.solve(graph, request).ranks, ranks, test.name + " library ranks on 1 and 4 threads");
+    failed += check_same(
+      exe::pagerank_serial(test.graph, make_options(3), teleport, {}).ranks, ranks, test.name + " library and serial ranks");
+
+    // a solve that is cancelled before it starts keeps the first iterate, which is the teleportation
+    const std::atomic<bool> cancel{ true };
+    auto stopped{ request };
+    stopped.cancel = &cancel;
+    const auto cancelled{ together.solve(graph, stopped) };
+    failed += check(cancelled.status == pagerank::Status::CANCELLED && cancelled.iterations == 0, test.name + " cancelling");
+    failed += check_close(cancelled.ranks, teleport, test.name + " cancelled ranks");
+
+    auto late{ request };
+    late.deadline = pagerank::Clock::now();
+    failed += check(together.solve(graph, late).status == pagerank::Status::DEADLINE, test.name + " deadline");
+  }
+
+  // offsets that go back down would have a row reach past the links
+  const std::vector<uint64_t> offsets{ 0, 2, 1, 3 };
+  const std::vector<uint32_t> sources{ 1, 2, 0 };
+  bool threw{ false };
+  try {
+    pagerank::Graph::from_csr(team, offsets, sources, {}, {});
+  } catch (const utility::Error& err) {
+    threw = err.error == utility::Error::ErrorCode::OUT_OF_BOUNDS_ERR;
+  }
+  failed += check(threw, "library rejecting decreasing offsets");
+
+  return failed;
+}
+
+static auto test_determinism() -> uint32_t {
+  uint32_t failed{ 0 };
+  for (const auto& test : make_cases()) {
+    for (const auto jobs : { 1u, 2u, 4u }) {
+      const auto name{ test.name + " with " + std::to_string(jobs) + " jobs" };
+      const auto serial{ exe::pagerank_serial(test.graph, make_options(jobs), {}, {}) };
+      const auto parallel{ exe::pagerank_parallel(test.graph, make_options(jobs), {}, {}) };
+      failed += check_same(serial.ranks, parallel.ranks, name + " serial (1 thread) and parallel ranks");
+      failed += check(serial.iterations == parallel.iterations, name + " serial and parallel iterations");
+
+      auto options{ make_options(jobs) };
+      options.method = utility::Method::GAUSS_SEIDEL;
+      failed += check_same(
+        exe::pagerank_serial(test.graph, options, {}, {}).ranks,
+        exe::pagerank_parallel(test.graph, options, {}, {}).ranks,
+        name + " Gauss-Seidel serial and parallel ranks");
+
+      options = make_options(jobs);
+      options.precision = utility::Precision::FLOAT;
+      failed += check_same(
+        exe::pagerank_serial(test.graph, options, {}, {}).ranks,
+        exe::pagerank_parallel(test.graph, options, {}, {}).ranks,
+        name + " float serial and parallel ranks");
+    }
+
+    // the graph itself does not depend on how many threads built it
+    const auto rebuilt{ Graph::from_edges(test.links, test.nodes, 1) };
+    failed += check(
+      std::ranges::equal(rebuilt.sources(), test.graph.sources()) && std::ranges::equal(rebuilt.weights(), test.graph.weights()),
+      test.name + " graphs built on 1 and 2 threads");
+  }
+
+  return failed;
+}
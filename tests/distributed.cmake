@@ -0,0 +1,22 @@
+# Run the same graph with `run --distributed` on 3 processes and with the serial solver on 3 jobs,
+# which have to write the very same ranks
+
+set(ARGS run --dims 3000x3000 --model rmat --seed 4 --iter 200 --tol 1e-12)
+
+execute_process(COMMAND ${EXE} ${ARGS} -fs --jobs 3 --output ${WORK_DIR}/serial.txt
+                RESULT_VARIABLE result OUTPUT_QUIET)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The serial run failed with ${result}")
+endif()
+
+execute_process(COMMAND ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} 3 ${EXE} ${ARGS} --distributed --jobs 1 --output ${WORK_DIR}/distributed.txt
+                RESULT_VARIABLE result OUTPUT_QUIET)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The distributed run failed with ${result}")
+endif()
+
+file(READ ${WORK_DIR}/serial.txt serial)
+file(READ ${WORK_DIR}/distributed.txt distributed)
+if (NOT serial STREQUAL distributed)
+    message(FATAL_ERROR "The distributed and the serial ranks differ")
+endif()
@@ -0,0 +1,363 @@
+/*
+    Parallel Systems Extracurricular Project -- Pagerank implementation in the context of the Parallel
+    Systems Course of the "Computer Engineering" Masters Programme of NKUA
+    Copyright (C) 2025 Christoforos-Marios Mamaloukas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Times the matrix operations of src/types.cxx and the solver kernels on generated graphs of a few
+// sizes, and compares every timing with a stored baseline. A benchmark that got slower than
+// `--threshold` times its baseline fails the run.
+//
+//   perf --baseline <path> [--threshold <factor>] [--tries <number>] [--jobs <number>]
+//        [--filter <text>] [--update]
+//
+// Every try repeats a benchmark for at least `min_try_ms_gc`, and the fastest try counts. A
+// benchmark slower than the threshold gets timed again before it fails. The
+// baseline is only good for the build type it was recorded with, so any other build skips the
+// comparison (exit code 77). `--update` records the timings of this run as the new baseline
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generate.hxx"
+#include "graph.hxx"
+#include "library.hxx"
+#include "solver.hxx"
+#include "types.hxx"
+
+#ifndef PAGERANK_BUILD_TYPE
+#define PAGERANK_BUILD_TYPE ""
+#endif
+
+using Clock = std::chrono::steady_clock;
+using Graph = utility::Graph;
+
+// --- TYPES --- //
+
+struct Settings {
+  std::string baseline_path{};
+  double      threshold{ 2.0 };
+  uint32_t    tries{ 5 };
+  uint32_t    jobs{ 2 };
+  std::string filter{};
+  bool        update{ false };
+};
+
+/// A benchmark runs its work once per call, and says how many units of work that was,
+/// so that the timing is per unit (an iteration, a matrix operation)
+struct Benchmark {
+  std::string                  name{};
+  std::function<uint32_t()>    run{};
+};
+
+// --- CONSTANTS --- //
+
+/// How long every try runs a benchmark for, at least
+constexpr double   min_try_ms_gc{ 50.0 };
+/// How many iterations a solver benchmark runs per call
+constexpr uint32_t solver_iterations_gc{ 10 };
+/// The sides of the matrices and the nodes of the graphs to benchmark with
+constexpr uint32_t matrix_sides_gc[]{ 256, 1024 };
+constexpr uint32_t product_sides_gc[]{ 64, 192 };
+constexpr uint32_t graph_nodes_gc[]{ 1 << 12, 1 << 15, 1 << 18 };
+constexpr uint32_t graph_degree_gc{ 16 };
+constexpr int      skip_code_gc{ 77 };
+
+// --- FUNCTION DECLARATIONS --- //
+
+static auto read_settings(
+  int argc,
+  char** argv) -> Settings;
+/// Read a baseline file into benchmark -> ms, along with the build type it was recorded with
+static auto load_baseline(
+  const std::string& path,
+  std::string& build) -> std::map<std::string, double>;
+static auto save_baseline(
+  const std::string& path,
+  const std::vector<std::pair<std::string, double>>& timings) -> void;
+
+/// The fastest of `tries` tries of `benchmark`, in ms per unit of work
+static auto time_benchmark(
+  const Benchmark& benchmark,
+  const uint32_t tries) -> double;
+
+static auto add_matrix_benchmarks(
+  std::vector<Benchmark>& benchmarks,
+  const uint32_t jobs) -> void;
+static auto add_solver_benchmarks(
+  std::vector<Benchmark>& benchmarks,
+  const std::vector<Graph>& graphs,
+  pagerank::Pool& pool,
+  const uint32_t jobs) -> void;
+
+// --- FUNCTION DEFINITIONS --- //
+
+auto main(int argc, char** argv) -> int {
+  Settings settings{};
+  std::string build{};
+  std::map<std::string, double> baseline{};
+  try {
+    settings = read_settings(argc, argv);
+    if (!settings.update) baseline = load_baseline(settings.baseline_path, build);
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << "\n";
+    return 2;
+  }
+
+  if (!settings.update && build != PAGERANK_BUILD_TYPE) {
+    std::cout << "The baseline was recorded with a \"" << build << "\" build, and this is a \""
+              << PAGERANK_BUILD_TYPE << "\" one, so there is nothing to compare with\n";
+    return skip_code_gc;
+  }
+
+  // the graphs are generated once, up front, and shared by every benchmark
+  std::vector<Graph> graphs{};
+  for (const auto nodes : graph_nodes_gc) {
+    graphs.push_back(Graph::from_edges(
+      utility::generate_links(utility::Model::ER, nodes, graph_degree_gc, 1, settings.jobs), nodes, settings.jobs));
+  }
+  graphs.push_back(Graph::from_edges(
+    utility::generate_links(utility::Model::RMAT, 1 << 16, graph_degree_gc, 1, settings.jobs), 1 << 16, settings.jobs));
+
+  pagerank::Pool pool{ settings.jobs };
+  std::vector<Benchmark> benchmarks{};
+  add_matrix_benchmarks(benchmarks, settings.jobs);
+  add_solver_benchmarks(benchmarks, graphs, pool, settings.jobs);
+
+  std::cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "ms"
+            << std::setw(14) << "baseline" << std::setw(10) << "ratio" << "\n";
+
+  uint32_t slower{ 0 };
+  std::vector<std::pair<std::string, double>> timings{};
+  for (const auto& benchmark : benchmarks) {
+    if (benchmark.name.find(settings.filter) == std::string::npos) continue;
+
+    auto ms{ time_benchmark(benchmark, settings.tries) };
+    const auto found{ baseline.find(benchmark.name) };
+    // a slow timing is mostly a noisy neighbor, so it only counts if it is slow a second time too
+    if (found != baseline.end() && ms/found->second > settings.threshold) ms = std::min(ms, time_benchmark(benchmark, settings.tries));
+    timings.emplace_back(benchmark.name, ms);
+
+    std::cout << std::left << std::setw(36) << benchmark.name << std::right << std::setw(14) << std::setprecision(4) << ms;
+    if (found == baseline.end()) {
+      std::cout << std::setw(14) << "-" << std::setw(10) << "-" << (settings.update ? "" : "  (not in the baseline)") << "\n";
+      continue;
+    }
+
+    const auto ratio{ ms/found->second };
+    const auto failed{ ratio > settings.threshold };
+    slower += failed;
+    std::cout << std::setw(14) << found->second << std::setw(10) << std::setprecision(3) << ratio
+              << (failed ? "  SLOWER" : "") << "\n";
+  }
+
+  if (settings.update) {
+    save_baseline(settings.baseline_path, timings);
+    std::cout << "Baseline written to " << settings.baseline_path << "\n";
+    return 0;
+  }
+
+  if (slower != 0) {
+    std::cout << slower << " benchmarks got more than " << settings.threshold << " times slower than the baseline\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+static auto read_settings(
+  int argc,
+  char** argv) -> Settings {
+  Settings settings{};
+  const auto number{ [](const std::string_view text, auto& value) {
+    const auto [end, error]{ std::from_chars(text.data(), text.data() + text.size(), value) };
+    if (error != std::errc{} || end != text.data() + text.size()) throw std::invalid_argument("Bad value " + std::string(text));
+  } };
+
+  for (int i{ 1 }; i < argc; i++) {
+    const std::string_view option{ argv[i] };
+    if (option == "--update") {
+      settings.update = true;
+      continue;
+    }
+    if (i + 1 >= argc) throw std::invalid_argument("Option " + std::string(option) + " has no value");
+
+    const std::string_view value{ argv[++i] };
+    if (option == "--baseline") settings.baseline_path = value;
+    else if (option == "--threshold") number(value, settings.threshold);
+    else if (option == "--tries") number(value, settings.tries);
+    else if (option == "--jobs") number(value, settings.jobs);
+    else if (option == "--filter") settings.filter = value;
+    else throw std::invalid_argument("Option " + std::string(option) + " is not recognized");
+  }
+
+  if (settings.baseline_path.empty()) throw std::invalid_argument("Option --baseline has no value");
+  if (settings.tries == 0 || settings.jobs == 0 || !(settings.threshold > 0.0))
+    throw std::invalid_argument("--tries, --jobs and --threshold have to be positive");
+  return settings;
+}
+
+static auto load_baseline(
+  const std::string& path,
+  std::string& build) -> std::map<std::string, double> {
+  std::ifstream file{ path };
+  if (!file) throw std::runtime_error("Could not open file " + path);
+
+  std::map<std::string, double> baseline{};
+  std::string line{};
+  while (std::getline(file, line)) {
+    if (line.starts_with("# build ")) build = line.substr(8);
+    if (line.empty() || line.front() == '#') continue;
+
+    const auto comma{ line.rfind(',') };
+    if (comma == std::string::npos) continue;
+    baseline[line.substr(0, comma)] = std::stod(line.substr(comma + 1));
+  }
+
+  return baseline;
+}
+
+static auto save_baseline(
+  const std::string& path,
+  const std::vector<std::pair<std::string, double>>& timings) -> void {
+  std::ofstream file{ path };
+  if (!file) throw std::runtime_error("Could not open file " + path);
+
+  file << "# The fastest time of every benchmark of tests/perf.cxx, in ms per operation or iteration\n"
+       << "# build " << PAGERANK_BUILD_TYPE << "\n";
+  for (const auto& [name, ms] : timings) file << name << "," << std::setprecision(6) << ms << "\n";
+}
+
+static auto time_benchmark(
+  const Benchmark& benchmark,
+  const uint32_t tries) -> double {
+  // a first call warms the caches up and faults the pages in
+  benchmark.run();
+
+  double fastest{ INFINITY };
+  for (uint32_t t{ 0 }; t < tries; t++) {
+    uint64_t units{ 0 };
+    const auto start{ Clock::now() };
+    double elapsed{ 0.0 };
+    do {
+      units += benchmark.run();
+      elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    } while (elapsed < min_try_ms_gc);
+
+    fastest = std::min(fastest, elapsed/static_cast<double>(units));
+  }
+
+  return fastest;
+}
+
+static auto add_matrix_benchmarks(
+  std::vector<Benchmark>& benchmarks,
+  const uint32_t jobs) -> void {
+  // the matrices live as long as the benchmarks do. They are scaled by 1, since
+  // anything else would end up in denormals after enough calls
+  const auto matrix{ [](const uint32_t rows, const uint32_t columns) {
+    auto made{ std::make_shared<utility::Matrix>(rows, columns) };
+    for (uint32_t x{ 0 }; x < rows; x++) {
+      for (uint32_t y{ 0 }; y < columns; y++) (*made)(x, y) = 1.0/(1.0 + x + y);
+    }
+    return made;
+  } };
+
+  for (const auto side : matrix_sides_gc) {
+    const auto size{ "/" + std::to_string(side) };
+    const auto left{ matrix(side, side) };
+    const auto right{ matrix(side, side) };
+
+    benchmarks.push_back({ "matrix.copy" + size, [=] { *left = *right; return 1u; } });
+    benchmarks.push_back({ "matrix.add" + size, [=] { *left += *right; return 1u; } });
+    benchmarks.push_back({ "matrix.scale" + size, [=] { *left * 1.0; return 1u; } });
+    benchmarks.push_back({ "matrix.copy_paral" + size, [=] { left->copy_paral(*right, jobs); return 1u; } });
+    benchmarks.push_back({ "matrix.add_paral" + size, [=] { left->add_paral(*right, jobs); return 1u; } });
+    benchmarks.push_back({ "matrix.mul_paral" + size, [=] { left->mul_paral(1.0, jobs); return 1u; } });
+  }
+
+  for (const auto side : product_sides_gc) {
+    const auto size{ "/" + std::to_string(side) };
+    const auto left{ matrix(side, side) };
+    const auto right{ matrix(side, side) };
+
+    benchmarks.push_back({ "matrix.product" + size, [=] { (void)(*left * *right); return 1u; } });
+    benchmarks.push_back({ "matrix.product_paral" + size, [=] { (void)left->mul_paral(*right, jobs); return 1u; } });
+  }
+}
+
+static auto add_solver_benchmarks(
+  std::vector<Benchmark>& benchmarks,
+  const std::vector<Graph>& graphs,
+  pagerank::Pool& pool,
+  const uint32_t jobs) -> void {
+  utility::Options options{};
+  options.jobs = jobs;
+  options.dump_fac = 0.85;
+  options.iterations = solver_iterations_gc;
+
+  for (const auto& graph : graphs) {
+    const auto size{ "/" + std::string(&graph == &graphs.back() ? "rmat" : "er") + std::to_string(graph.get_nodes()) };
+    const auto* const matrix{ &graph };
+
+    benchmarks.push_back({ "solver.serial" + size, [=] {
+      return exe::pagerank_serial(*matrix, options, {}, {}).iterations;
+    } });
+    benchmarks.push_back({ "solver.parallel" + size, [=] {
+      return exe::pagerank_parallel(*matrix, options, {}, {}).iterations;
+    } });
+
+    auto gauss_seidel{ options };
+    gauss_seidel.method = utility::Method::GAUSS_SEIDEL;
+    benchmarks.push_back({ "solver.gauss_seidel" + size, [=] {
+      return exe::pagerank_parallel(*matrix, gauss_seidel, {}, {}).iterations;
+    } });
+
+    auto single{ options };
+    single.precision = utility::Precision::FLOAT;
+    benchmarks.push_back({ "solver.float" + size, [=] {
+      return exe::pagerank_parallel(*matrix, single, {}, {}).iterations;
+    } });
+
+    auto blocked{ options };
+    blocked.block_nodes = std::max(graph.get_nodes()/8, 1u);
+    benchmarks.push_back({ "solver.blocked" + size, [=] {
+      return exe::pagerank_parallel(*matrix, blocked, {}, {}).iterations;
+    } });
+
+    // the library keeps its pool and its buffers from one solve to the next
+    auto library{ std::make_shared<pagerank::Graph>(
+      pagerank::Graph::from_csr(pool, graph.offsets(), graph.sources(), graph.weights(), graph.out_degrees())) };
+    auto solver{ std::make_shared<pagerank::Solver>(pool, 4*jobs) };
+    benchmarks.push_back({ "library.solve" + size, [=] {
+      return solver->solve(*library, { .damping{ 0.85 }, .iterations{ solver_iterations_gc } }).iterations;
+    } });
+  }
+}